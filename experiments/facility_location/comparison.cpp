@@ -2,13 +2,17 @@
 #include <algorithm>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <random>
+#include <string>
+#include <vector>
 
 #include "facility_location/RandomStepWalker.h"
 #include "facility_location/BestStepWalker.h"
 #include "facility_location/SimpleFormat.h"
 #include "facility_location/PrimDualSchema.h"
 #include "facility_location/util.h"
+#include "paal/BatchLoader.h"
 #include "paal/search.h"
 #include "paal/ProgressCtrl.h"
 #include "paal/StepCtrl.h"
@@ -108,12 +112,19 @@ int main(int argc, char **argv)
   table.push_algo("3 apx");
   table.push_algo("random");
 
-  for (auto gid : {"2511EuclS", "1811EuclS", "1211EuclS", "111EuclS",
-      "1911EuclS", "2711EuclS"}) {
-    Instance instance(format("UflLib/Euclid/%.txt", gid));
-    rnd.instance = bls.instance = apx.instance = &instance;
+  std::vector<std::string> gids = {"2511EuclS", "1811EuclS", "1211EuclS",
+    "111EuclS", "1911EuclS", "2711EuclS"};
+  // the next instances are parsed while the current one is solved
+  paal::BatchLoader<Instance> loader(gids.size(), [&](size_t i)
+      {
+        return std::unique_ptr<Instance>(
+          new Instance(format("UflLib/Euclid/%.txt", gids[i])));
+      });
+  for (auto gid : gids) {
+    std::unique_ptr<Instance> instance = loader.next();
+    rnd.instance = bls.instance = apx.instance = instance.get();
     table.columns.push_back(gid);
-    table.records[0].results.push_back(instance.optimal_cost());
+    table.records[0].results.push_back(instance->optimal_cost());
     table.records[1].test(bls);
     table.records[2].test(apx);
     table.records[3].test(rnd);
@@ -9,6 +9,7 @@
 #include <tsp/MCTS_tsp.h>
 #include <tsp/TSPLIB.h>
 #include "paal/search.h"
+#include "paal/parallel_search.h"
 #include "paal/StepCtrl.h"
 #include "tsp/TwoOptWalker.h"
 #include "tsp/Christofides.h"
@@ -89,6 +90,38 @@ struct AnneAlgo : LocalSearchAlgo
   }
 };
 
+/** @brief [implements Algo] independent hill climbing restarts run on all
+ * cores; each restart gets its own random stream and iteration budget */
+struct MultiStartHillAlgo
+{
+  MultiStartHillAlgo(Matrix &_matrix, size_t _it, size_t _restarts) :
+    matrix(_matrix), it(_it), restarts(_restarts) {}
+  Matrix &matrix;
+  size_t it, restarts;
+
+  template<typename Logger> double run(Logger &logger) const
+  {
+    std::vector<tsp::TwoOptWalker<Matrix> > walkers;
+    std::vector<std::mt19937> randoms;
+    std::vector<paal::IterationCtrl> progress_ctrls;
+    std::vector<paal::HillClimb> step_ctrls(restarts);
+    for (size_t i = 0; i < restarts; ++i)
+    {
+      std::vector<size_t> cycle;
+      tsp::cycle_shuffle(cycle, matrix.size1(), random_);
+      walkers.push_back(tsp::TwoOptWalker<Matrix>(matrix, cycle));
+      randoms.push_back(std::mt19937(random_()));
+      progress_ctrls.push_back(paal::IterationCtrl(it));
+    }
+    paal::BestSlot<std::vector<size_t> > best;
+    paal::parallel_search(walkers, randoms, progress_ctrls, step_ctrls, best,
+        [](const tsp::TwoOptWalker<Matrix> &w)
+          -> const std::vector<size_t> & { return w.cycle; });
+    logger.log(best.fitness());
+    return best.fitness();
+  }
+};
+
 /** @brief [implements Algo] */
 template<typename Policy> struct MCTSAlgo
 {
@@ -97,7 +130,7 @@ template<typename Policy> struct MCTSAlgo
   size_t full_search_;
   double samples_ratio_;
 
-  MCTSAlgo(Policy policy, size_t samples_ratio = 500, size_t full_search = 9) :
+  MCTSAlgo(Policy policy, size_t samples_ratio = 500, size_t full_search = 14) :
     state_(NULL), policy_(policy), full_search_(full_search),
     samples_ratio_(samples_ratio) {}
 
@@ -30,13 +30,16 @@ int main(int argc, char **argv)
     auto epsbest = make_algo(PolicyEpsBest<Random>(random_));
     table.push_algo("PolicyMuSigma");
     auto musigma = make_algo(PolicyMuSigma<Random>(random_));
+    table.push_algo("PolicyUCT");
+    auto uct = make_algo(PolicyUCT<Random>(random_));
 
     Matrix matrix;
     dir.graphs[gid].load(matrix);
 
     for (size_t limit = matrix.size1(); limit > matrix.size1() / 11; limit /= 2) {
       State state(matrix, limit);
-      randmean.state_ = epsmean.state_ = epsbest.state_ = musigma.state_ = &state;
+      randmean.state_ = epsmean.state_ = epsbest.state_ = musigma.state_ =
+        uct.state_ = &state;
       table.columns.push_back(format("%, limit %", gid, limit));
       table.records[0].results.push_back(dir.graphs[gid].optimal_fitness);
       double start;
@@ -52,6 +55,9 @@ int main(int argc, char **argv)
       start = paal::realtime_sec();
       table.records[4].test(musigma);
       std::cerr << "runtime " << paal::realtime_sec() - start << std::endl;
+      start = paal::realtime_sec();
+      table.records[5].test(uct);
+      std::cerr << "runtime " << paal::realtime_sec() - start << std::endl;
       std::cerr << "done " << gid << " / " << limit << std::endl;
     }
     std::ofstream tex(resdir(format("%.tex", gid)));
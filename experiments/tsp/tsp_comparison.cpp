@@ -20,6 +20,7 @@ int main(int argc, char **argv)
   table.push_algo("HillClimb");
   table.push_algo("MonteCarloSearch");
   table.push_algo("Christofides");
+  table.push_algo("MultiStartHill");
 
   tsp::TSPLIB_Directory dir("./TSPLIB/symmetrical/");
   size_t it = 0;
@@ -46,6 +47,12 @@ int main(int argc, char **argv)
     stop = paal::realtime_sec();
     std::cerr << "runtime " << stop - start << std::endl;
 
+    MultiStartHillAlgo multistart(matrix, 10 * matrix.size1(), 8);
+    start = paal::realtime_sec();
+    table.records[4].test(multistart);
+    stop = paal::realtime_sec();
+    std::cerr << "runtime " << stop - start << std::endl;
+
     MCTSAlgo<PolicyRandMean<std::mt19937> > mctsalgo(
       PolicyRandMean<std::mt19937>(random_), samplelimit[it]);
     State state(matrix, matrix.size1() / 4);
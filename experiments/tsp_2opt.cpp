@@ -1,5 +1,8 @@
 #include "tsp/TSPLIB.h"
 #include "tsp/TwoOptWalker.h"
+#include "tsp/NeighborTwoOptWalker.h"
+#include "tsp/LinKernighanWalker.h"
+#include "tsp/QueueTwoOptWalker.h"
 #include "tsp/util.h"
 #include "paal/search.h"
 #include "paal/ProgressCtrl.h"
@@ -61,6 +64,72 @@ struct AnneAlgo : Algo
   }
 };
 
+struct NeighborHillAlgo  // implements Algo
+{
+  NeighborHillAlgo(Matrix &_matrix) : matrix(_matrix)
+  {
+    tsp::neighbor_lists(matrix, 8, neighbors);
+  }
+  Matrix &matrix;
+  tsp::NeighborLists neighbors;
+
+  template<typename Logger> double run(Logger &logger) const
+  {
+    std::vector<size_t> cycle;
+    tsp::cycle_shuffle(cycle, matrix.size1(), random_);
+    tsp::NeighborTwoOptWalker<Matrix> walker(matrix, neighbors, cycle);
+    paal::IterationCtrl progress_ctrl(10000000);
+    paal::HillClimb step_ctrl;
+    paal::search(walker, random_, progress_ctrl, step_ctrl, logger);
+    return walker.current_fitness();
+  }
+};
+
+struct LinKernighanHillAlgo  // implements Algo
+{
+  LinKernighanHillAlgo(Matrix &_matrix) : matrix(_matrix)
+  {
+    tsp::neighbor_lists(matrix, 8, neighbors);
+  }
+  Matrix &matrix;
+  tsp::NeighborLists neighbors;
+
+  template<typename Logger> double run(Logger &logger) const
+  {
+    std::vector<size_t> cycle;
+    tsp::cycle_shuffle(cycle, matrix.size1(), random_);
+    tsp::LinKernighanWalker<Matrix> walker(matrix, neighbors, cycle);
+    paal::IterationCtrl progress_ctrl(1000000);
+    paal::HillClimb step_ctrl;
+    paal::search(walker, random_, progress_ctrl, step_ctrl, logger);
+    return walker.current_fitness();
+  }
+};
+
+struct QueueHillAlgo  // implements Algo
+{
+  QueueHillAlgo(Matrix &_matrix) : matrix(_matrix)
+  {
+    tsp::neighbor_lists(matrix, 8, neighbors);
+  }
+  Matrix &matrix;
+  tsp::NeighborLists neighbors;
+
+  template<typename Logger> double run(Logger &logger) const
+  {
+    typedef tsp::QueueTwoOptWalker<Matrix> Walker;
+    std::vector<size_t> cycle;
+    tsp::cycle_shuffle(cycle, matrix.size1(), random_);
+    Walker walker(matrix, neighbors, cycle);
+    paal::IterationCtrl iteration_ctrl(10000000);
+    paal::ConvergenceCtrl<Walker, paal::IterationCtrl> progress_ctrl(
+        walker, iteration_ctrl);
+    paal::HillClimb step_ctrl;
+    paal::search(walker, random_, progress_ctrl, step_ctrl, logger);
+    return walker.current_fitness();
+  }
+};
+
 int main()
 {
   tsp::TSPLIB_Directory dir("./TSPLIB/symmetrical/");
@@ -75,6 +144,12 @@ for (auto &gid : graph_ids)
       format("hill_climb %", dir.graphs[gid].filename), HillAlgo(matrix), 5);
     sl.test(
       format("annealing %", dir.graphs[gid].filename), AnneAlgo(matrix), 5);
+    sl.test(format("neighbor_hill_climb %", dir.graphs[gid].filename),
+      NeighborHillAlgo(matrix), 5);
+    sl.test(format("lin_kernighan_hill_climb %", dir.graphs[gid].filename),
+      LinKernighanHillAlgo(matrix), 5);
+    sl.test(format("queue_hill_climb %", dir.graphs[gid].filename),
+      QueueHillAlgo(matrix), 5);
     sl.dump(std::cout);
     std::cout << std::flush;
   }
@@ -6,14 +6,19 @@
 #include <string>
 #include <iostream>
 #include <vector>
+#include <memory>
 #include <set>
 
 //#include "tsp/annealing.h"
 #include "tsp/Christofides.h"
 //#include "tsp/CycleWalker.h"
 //#include "tsp/monitor.h"
+#include "tsp/Pipeline.h"
+#include "tsp/QueueTwoOptWalker.h"
 #include "tsp/TSPLIB.h"
+#include "paal/BatchLoader.h"
 #include "paal/ProgressCtrl.h"
+#include "paal/StepCtrl.h"
 
 #include "./format.h"
 
@@ -24,6 +29,12 @@ static const int CHRIST_FLAG = 0x0001;
 static const int ANNEAL_FLAG = 0x0002;
 static const int HILL_FLAG = 0x0004;
 
+/** @brief test case loaded by paal::BatchLoader */
+struct LoadedCase {
+    tsp::TSPLIB_Matrix mtx;
+    std::string ewt;
+};
+
 /*
  * @brief testing routine for different TSP heuristics.
  */
@@ -34,10 +45,19 @@ int main(int argc, char **argv) {
                 ("path", po::value<std::string>(), "path to TSPLIB")
                 ("tests", po::value<std::vector<int> >()->multitoken(),
                   "tests to run (OR them to combine): \n"
-                  "1 - Christofides, \n"
+                  "1 - Christofides (greedy otherwise), \n"
                   //"2 - annealing, \n"
-                  //"4 - hill climb \n"
+                  "4 - hill climb with 2-opt \n"
                   "default: 1")
+                ("matching", po::value<std::string>()->default_value("dense"),
+                  "matching of Christofides: \n"
+                  "dense, sparse (non-geometric cases), \n"
+                  "greedy (all cases, no Blossom V)")
+                ("cache", "keep parsed test cases in binary files "
+                  "next to them")
+                ("load_threads", po::value<int>()->default_value(0),
+                  "threads loading the next test cases while the current "
+                  "one runs, 0 means one per core")
                 ("time_limit", po::value<int>()->default_value(30),
                   "time limit for meta heuristics in seconds")
                 ("cases", po::value<std::vector<std::string> >()->multitoken(),
@@ -67,68 +87,76 @@ int main(int argc, char **argv) {
       cases.insert(cases_param.begin(), cases_param.end());
     }
 
+    tsp::MatchingImplEnum matching = tsp::kMatchingDense;
+    if (vm["matching"].as<std::string>() == "sparse")
+        matching = tsp::kMatchingSparse;
+    else if (vm["matching"].as<std::string>() == "greedy")
+        matching = tsp::kMatchingGreedy;
+
     tsp::TSPLIB_Directory dir(vm["path"].as<std::string>());
-    tsp::TSPLIB_Matrix mtx;
-    double start, end;
-    double real_time;
+    std::vector<std::pair<std::string, tsp::TSPLIB_Directory::Graph> > graphs;
+    for (auto &graph_pair : dir.graphs)
+        if (cases.empty() || cases.count(graph_pair.first))
+            graphs.push_back(graph_pair);
+
+    // the next test cases are parsed while the current one runs
+    bool use_cache = vm.count("cache");
+    paal::BatchLoader<LoadedCase> loader(graphs.size(), [&](size_t i) {
+        std::unique_ptr<LoadedCase> loaded(new LoadedCase());
+        loaded->ewt = graphs[i].second.load(loaded->mtx, use_cache);
+        return loaded;
+    }, vm["load_threads"].as<int>());
+
+    double time = vm["time_limit"].as<int>();
     std::string method;
-    for (auto &graph_pair : dir.graphs) {
-        if (!cases.empty() && !cases.count(graph_pair.first)) continue;
+    for (auto &graph_pair : graphs) {
         auto &graph = graph_pair.second;
         std::cout << std::endl << graph_pair.first << std::endl
                 << format("optimal fitness= %", graph.optimal_fitness)
                 << std::endl;
+        std::unique_ptr<LoadedCase> loaded = loader.next();
+        tsp::TSPLIB_Matrix &mtx = loaded->mtx;
+        const std::string &ewt = loaded->ewt;
         for (int flag : tests) {
             method = "";
-            std::string ewt = graph.load(mtx);
-
             typedef std::mt19937 Random;
             Random random(64236738);
-            // double time = vm["time_limit"].as<int>();
 
-            typedef std::vector<int> CycleT;
-            CycleT cycle;
-
-            start = paal::realtime_sec();
-
-            cycle.resize(mtx.size1());
+            tsp::Pipeline<tsp::TSPLIB_Matrix> pipeline(mtx);
+            pipeline.matching = matching;
+            pipeline.ewt = ewt;
+            pipeline.points = &mtx.pos;
 
             if (flag & CHRIST_FLAG) {
               method += "Christofides";
-              if (ewt == "EUC_2D" || ewt == "CEIL_2D" || ewt == "ATT") {
-                  tsp::christofides<tsp::TSPLIB_Matrix, CycleT>
-                    (mtx, cycle, mtx.size1(), ewt, &mtx.pos);
-              } else {
-                  tsp::christofides<tsp::TSPLIB_Matrix, CycleT >
-                    (mtx, cycle, mtx.size1());
-              }
+              pipeline.construct_cycle(tsp::kConstructChristofides);
             } else {
-              tsp::cycle_shuffle(cycle, mtx.size1(), random);
+              method += "greedy";
+              pipeline.construct_cycle(tsp::kConstructGreedy);
             }
 
-            /*tsp::CycleWalker<tsp::TSPLIB_Matrix, Random>
-              walker(mtx, cycle, random);
-            tsp::TimeMonitor monitor(time);
-            tsp::BoltzmannDistr<Random>
-            distr(tsp::fitness(mtx, cycle) / mtx.size1(), 1e-300, random);
-
             if (flag & HILL_FLAG) {
-                method += "+ hill_climb";
-                tsp::hill_climb(walker, monitor);
+              method += "+ hill_climb";
+              typedef tsp::QueueTwoOptWalker<tsp::TSPLIB_Matrix> Walker;
+              Walker walker(mtx, pipeline.neighbors(10), pipeline.cycle);
+              // the budget covers all stages
+              paal::TimeCtrl time_ctrl(time - pipeline.times.total(), 1000);
+              paal::ConvergenceCtrl<Walker, paal::TimeCtrl>
+                progress_ctrl(walker, time_ctrl);
+              paal::HillClimb step_ctrl;
+              pipeline.improve(walker, random, progress_ctrl, step_ctrl);
             }
 
-            if (flag & ANNEAL_FLAG) {
-                method += "+ annealing";
-                tsp::annealing(walker, monitor, distr);
-            }*/
-
-            end = paal::realtime_sec();
-            real_time = (long long) ((end - start) * 1e3);
-            double best_fitness = tsp::fitness(mtx, cycle);
-            std::cout << format("%: fitness=% (%) real_time=%",
+            double best_fitness = tsp::fitness(mtx, pipeline.cycle);
+            const tsp::PipelineTimes &times = pipeline.times;
+            std::cout << format("%: fitness=% (%) real_time=% "
+                                "(construct=% shortcut=% improve=%)",
                                 method, best_fitness,
                                 best_fitness / graph.optimal_fitness,
-                                real_time)
+                                (long long) (times.total() * 1e3),
+                                (long long) (times.construct * 1e3),
+                                (long long) (times.shortcut * 1e3),
+                                (long long) (times.improve * 1e3))
                       << std::endl;
         }
     }
@@ -0,0 +1,68 @@
+// compares running times of TwoOptWalker over different tour representations
+// to find the instance size at which cheap reversals start to pay off
+#include "tsp/TSPLIB.h"
+#include "tsp/TwoOptWalker.h"
+#include "tsp/util.h"
+#include "rsarray/RSArray.h"
+#include "splay/SplayTree.h"
+#include "paal/search.h"
+#include "paal/ProgressCtrl.h"
+#include "paal/StepCtrl.h"
+#include "paal/Logger.h"
+#include <random>
+#include <vector>
+#include <iostream>
+#include "format.h"
+
+/** @returns seconds per 10^6 steps of hill climbing from the given cycle */
+template<typename Tour, typename Matrix>
+double run(const Matrix &matrix, const std::vector<size_t> &cycle,
+    size_t it)
+{
+  std::mt19937 random(786284);
+  tsp::TwoOptWalker<Matrix, Tour> walker(matrix, cycle);
+  paal::IterationCtrl progress_ctrl(it);
+  paal::HillClimb step_ctrl;
+  paal::VoidLogger logger;
+  double begin = paal::realtime_sec();
+  paal::search(walker, random, progress_ctrl, step_ctrl, logger);
+  return (paal::realtime_sec() - begin) * 1e6 / it;
+}
+
+/** @brief runs all backends on a view of the matrix */
+struct Backends
+{
+  Backends(const std::vector<size_t> &_cycle, size_t _it) :
+    cycle(_cycle), it(_it) {}
+  const std::vector<size_t> &cycle;
+  size_t it;
+
+  template<typename Matrix> std::string operator()(const Matrix &matrix) const
+  {
+    return format("%, %, %",
+        run<std::vector<size_t> >(matrix, cycle, it),
+        run<rsarray::RSArray<size_t> >(matrix, cycle, it),
+        run<splay::SplayTree<size_t> >(matrix, cycle, it));
+  }
+};
+
+int main()
+{
+  enum { it = 1000000 };
+  tsp::TSPLIB_Directory dir("./TSPLIB/symmetrical/");
+  std::vector<std::string> graph_ids = {"ulysses22", "brazil58", "kroA100",
+      "pr1002", "d2103", "pcb3038", "fl3795", "rl5934", "d15112", "pla33810",
+      "pla85900"};
+  std::mt19937 random(786284);
+  tsp::TSPLIB_Matrix matrix;
+  std::cout << "graph, n, vector, rsarray, splay\n";
+  for (auto &gid : graph_ids)
+  {
+    dir.graphs[gid].load(matrix);
+    std::vector<size_t> cycle;
+    tsp::cycle_shuffle(cycle, matrix.size1(), random);
+    std::cout << format("%, %, %\n", gid, matrix.size1(),
+        matrix.with_metric(Backends(cycle, it))) << std::flush;
+  }
+  return 0;
+}
@@ -3,6 +3,7 @@
 
 #include <mcts/MonteCarloTree.h>
 
+#include <cassert>
 #include <random>
 #include <limits>
 #include <cmath>
@@ -35,8 +36,10 @@ namespace facility_location
       const double facility_cost_;
       const size_t facilities_count_;
       const size_t cities_count_;
-      //! Order in which cities/facilities are being processed.
+      //! Order in which cities/facilities are being processed, from the
+      //! back; ordering_[0, left_) are not processed yet.
       std::vector<size_t> ordering_;
+      size_t left_;
       //! Already open facilities.
       std::vector<size_t> facilities_;
 
@@ -80,7 +83,7 @@ namespace facility_location
                        size_t facilities_count, size_t cities_count) :
           matrix_(matrix), facility_cost_(facility_cost),
           facilities_count_(facilities_count), cities_count_(cities_count),
-          ordering_(facilities_count)
+          ordering_(facilities_count), left_(facilities_count)
       {
         for (size_t i = 0; i < facilities_count_; ++i)
         {
@@ -96,34 +99,51 @@ namespace facility_location
        */
       bool is_terminal() const
       {
-        return ordering_.size() == 0;
+        return left_ == 0;
       }
 
+      //! [implements mcts::UndoState::Undo] whether apply opened a facility
+      typedef bool Undo;
+
       /**
        * @brief Applies a move to the state.
+       * @returns token reverting the move, see: undo
+       */
+      Undo apply(const Move& move)
+      {
+        assert(!is_terminal());
+        --left_;
+        if (move) facilities_.push_back(ordering_[left_]);
+        return move;
+      }
+
+      /**
+       * @brief Reverts the last move not reverted yet.
        */
-      void apply(const Move& move)
+      void undo(const Undo& opened)
       {
-        if (move) facilities_.push_back(ordering_.back());
-        ordering_.pop_back();
+        if (opened) facilities_.pop_back();
+        ++left_;
       }
 
       /**
        * @brief Estimates rest of playout by using Meyerson's
-       *        incremental algorithm.
+       *        incremental algorithm, leaves the state unchanged.
        */
       template<typename Random> Fitness estimate_playout(Random& random)
       {
         double rand, dist;
-        while (ordering_.size())
+        size_t opened = facilities_.size();
+        for (size_t i = left_; i--;)
         {
           rand = static_cast<double>(random())/random.max();
-          dist = distance_from_facilities(ordering_.back());
+          dist = distance_from_facilities(ordering_[i]);
           if (dist/facility_cost_ > rand)
-            facilities_.push_back(ordering_.back());
-          ordering_.pop_back();
+            facilities_.push_back(ordering_[i]);
         }
-        return calculate_cost();
+        Fitness cost = calculate_cost();
+        facilities_.resize(opened);
+        return cost;
       }
 
       /**
@@ -135,9 +155,9 @@ namespace facility_location
         return {Move(false), Move(true)};
       }
 
-      size_t moves_count() const { return ordering_.size() ? 2 : 0; }
+      size_t moves_count() const { return left_ ? 2 : 0; }
 
-      size_t left_decisions() const { return ordering_.size(); }
+      size_t left_decisions() const { return left_; }
   };
 }
 #endif  // FACILITY_LOCATION_MCTS_FL_H_
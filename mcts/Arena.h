@@ -0,0 +1,110 @@
+#ifndef MCTS_ARENA_H_
+#define MCTS_ARENA_H_
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mcts
+{
+  /**
+   * @brief bump allocator handing out contiguous blocks of T from large
+   * chunks; memory is released only in bulk, by clear(), which keeps the
+   * chunks for further allocations
+   *
+   * The arena neither constructs nor destroys objects, the caller
+   * placement-news them into the storage returned by allocate().
+   */
+  template<typename T> class Arena
+  {
+    public:
+      /** @param chunk number of objects in a chunk */
+      explicit Arena(size_t chunk = 1 << 12) :
+        chunk_(chunk), current_(0), used_(0), allocated_(0)
+      {
+        assert(chunk_);
+      }
+
+      Arena(Arena &&other) : chunk_(other.chunk_), current_(0), used_(0),
+        allocated_(0)
+      {
+        swap(other);
+      }
+
+      Arena(const Arena &) = delete;
+      Arena & operator=(const Arena &) = delete;
+
+      /** @return uninitialized storage for n consecutive objects; O(1)
+       * amortized */
+      T * allocate(size_t n)
+      {
+        assert(n);
+        while (current_ < chunks_.size() && chunks_[current_].size < used_ + n)
+        {
+          ++current_;
+          used_ = 0;
+        }
+        if (current_ == chunks_.size())
+        {
+          Chunk chunk;
+          chunk.size = std::max(chunk_, n);
+          chunk.slots.reset(new Slot[chunk.size]);
+          chunks_.push_back(std::move(chunk));
+        }
+        T *block = reinterpret_cast<T *>(&chunks_[current_].slots[used_]);
+        used_ += n;
+        allocated_ += n;
+        return block;
+      }
+
+      /** @brief invalidates all the storage handed out, without running
+       * destructors */
+      void clear()
+      {
+        current_ = used_ = allocated_ = 0;
+      }
+
+      /** @return number of objects allocated since the last clear() */
+      size_t allocated() const
+      {
+        return allocated_;
+      }
+
+      /** @return number of objects the chunks can hold */
+      size_t capacity() const
+      {
+        size_t total = 0;
+        for (const Chunk &chunk : chunks_) total += chunk.size;
+        return total;
+      }
+
+      void swap(Arena &other)
+      {
+        std::swap(chunk_, other.chunk_);
+        chunks_.swap(other.chunks_);
+        std::swap(current_, other.current_);
+        std::swap(used_, other.used_);
+        std::swap(allocated_, other.allocated_);
+      }
+
+    private:
+      typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Slot;
+
+      struct Chunk
+      {
+        std::unique_ptr<Slot[]> slots;
+        size_t size;
+      };
+
+      size_t chunk_;
+      std::vector<Chunk> chunks_;
+      /** @brief chunk being filled and number of its slots handed out */
+      size_t current_, used_;
+      size_t allocated_;
+  };
+}  // namespace mcts
+
+#endif  // MCTS_ARENA_H_
@@ -3,12 +3,21 @@
 
 #include <gtest/gtest_prod.h>
 
+#include <atomic>
 #include <cassert>
+#include <cmath>
 #include <limits>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
 #include <vector>
 #include <utility>
 #include <algorithm>
 #include <memory>
+#include <new>
+#include <type_traits>
+
+#include "mcts/Arena.h"
+#include "mcts/TranspositionTable.h"
 
 namespace mcts
 {
@@ -24,10 +33,255 @@ namespace mcts
     template<typename Random> Fitness estimate_playout(Random& random);
     const std::vector<Move> moves() const
   };
+
+  optional extension of State, used by MonteCarloTree to roll the root state
+  back in place after every playout instead of copying it
+  concept UndoState : State
+  {
+    concept Undo;
+
+    // returns token reverting this move
+    Undo apply(const Move &move);
+    // reverts the last applied move not reverted yet
+    void undo(const Undo &undo);
+    // leaves the state unchanged
+    template<typename Random> Fitness estimate_playout(Random& random);
+  };
+
+  optional extension of State, lets MonteCarloTree share statistics of
+  states reached by different sequences of moves, see: transpositions
+  concept HashState : State
+  {
+    // equal for equal states, preferably maintained incrementally
+    uint64_t hash() const;
+    // hash() after apply(move)
+    uint64_t hash(const Move &move) const;
+    // after apply(move), cost of the moves applied so far: the part of the
+    // estimates of playouts from there which may differ between equal
+    // states
+    Fitness cost(const Move &move) const;
+  };
+
+  optional extension of State, lets MonteCarloTree create children of a
+  node lazily, see: widening
+  concept WideningState : State
+  {
+    // the first count of moves() (all if fewer), best first; the result
+    // for a larger count starts with these
+    const std::vector<Move> moves(size_t count) const;
+  };
+
+  optional extension of Policy, required by transpositions, implemented by
+  the policies of Policy.h
+  concept ShiftPolicy : Policy
+  {
+    // adds offset to all the estimates held by payload
+    void shift(Payload &payload, Fitness offset);
+  };
+
+  optional extension of Policy, required by parallel search
+  concept ParallelPolicy : Policy
+  {
+    // accounts for a playout in progress through node[chosen], as if it
+    // returned loss; undone by remove_virtual_loss with the same loss
+    template<typename Node>
+    void add_virtual_loss(Node &node, size_t chosen, Fitness loss);
+    template<typename Node>
+    void remove_virtual_loss(Node &node, size_t chosen, Fitness loss);
+    // adds statistics of from to into
+    void merge(Payload &into, const Payload &from);
+  };
+
+  optional extension of Policy, for data the policy keeps in every node,
+  accessed as node.cache(); unlike the Payload it is never shared through
+  transpositions nor merged, so it may describe the children of the node
+  concept CachePolicy : Policy
+  {
+    // trivially destructible
+    struct Cache;
+  };
   */
 
+  /** @brief parallelism of MonteCarloTree::search */
+  enum ParallelEnum
+  {
+    /** @brief one tree, all playouts on the calling thread */
+    kSequential,
+    /** @brief an independent tree per thread; statistics of the root
+     * children are merged to choose the move */
+    kRootParallel,
+    /** @brief one tree shared by the threads; nodes are locked while
+     * playouts pass through them and playouts in progress count as virtual
+     * losses, spreading the threads over the tree */
+    kTreeParallel
+  };
+
+  /** @brief progressive widening: a node with N visits has at most
+   * max(1, ceil(coefficient * N^exponent)) children; disabled while the
+   * coefficient is 0 */
+  struct Widening
+  {
+    double coefficient = 0;
+    double exponent = .5;
+
+    bool enabled() const { return coefficient > 0; }
+
+    size_t children(size_t visits) const
+    {
+      return std::max(1., std::ceil(coefficient * std::pow(visits, exponent)));
+    }
+  };
+
+  /** @brief spin lock held for the lifetime of the guard; for short
+   * critical sections */
+  class SpinGuard
+  {
+    public:
+      explicit SpinGuard(std::atomic<bool> &flag) : flag_(flag)
+      {
+        while (flag_.exchange(true, std::memory_order_acquire))
+          std::this_thread::yield();
+      }
+      ~SpinGuard() { flag_.store(false, std::memory_order_release); }
+
+      SpinGuard(const SpinGuard &) = delete;
+      SpinGuard & operator=(const SpinGuard &) = delete;
+
+    private:
+      std::atomic<bool> &flag_;
+  };
+
+  /** @brief [paal::ProgressCtrl] shared by the threads of a parallel
+   * search, with the best and worst estimate found */
+  template<typename ProgressCtrl> class SharedProgress
+  {
+    public:
+      explicit SharedProgress(ProgressCtrl &progress_ctrl) :
+        progress_ctrl_(progress_ctrl), stopped_(false), iteration_(0),
+        best_(std::numeric_limits<Fitness>::infinity()), worst_(0),
+        seen_(false) {}
+
+      /**
+       * @brief starts a playout unless the search is over
+       * @param iteration number of the playout
+       * @param loss virtual loss: the worst finite estimate so far, 0 before
+       *        the first one
+       **/
+      bool next(size_t &iteration, Fitness &loss)
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopped_ || progress_ctrl_.progress(best_) > 1)
+        {
+          stopped_ = true;
+          return false;
+        }
+        iteration = iteration_++;
+        loss = worst_;
+        return true;
+      }
+
+      /** @brief reports the estimate of a playout */
+      void done(Fitness estimate)
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        best_ = std::min(best_, estimate);
+        if (std::isfinite(estimate) && (!seen_ || worst_ < estimate))
+        {
+          worst_ = estimate;
+          seen_ = true;
+        }
+      }
+
+    private:
+      ProgressCtrl &progress_ctrl_;
+      std::mutex mutex_;
+      bool stopped_;
+      size_t iteration_;
+      Fitness best_, worst_;
+      bool seen_;
+  };
+
+  /** @brief std::true_type iff State implements [mcts::UndoState], i.e.
+   * declares the Undo type */
+  template<typename State> class is_undo_state
+  {
+      template<typename S> static std::true_type test(typename S::Undo *);
+      template<typename S> static std::false_type test(...);
+    public:
+      typedef decltype(test<State>(nullptr)) type;
+      static const bool value = type::value;
+  };
+
+  /** @brief std::true_type iff State implements [mcts::HashState] */
+  template<typename State> class is_hash_state
+  {
+      template<typename S> static std::true_type test(decltype(
+            std::declval<const S &>().hash(
+              std::declval<const typename S::Move &>())) *);
+      template<typename S> static std::false_type test(...);
+    public:
+      typedef decltype(test<State>(nullptr)) type;
+      static const bool value = type::value;
+  };
+
+  /** @brief std::true_type iff State implements [mcts::WideningState] */
+  template<typename State> class is_widening_state
+  {
+      template<typename S> static std::true_type test(decltype(
+            std::declval<const S &>().moves(size_t()))*);
+      template<typename S> static std::false_type test(...);
+    public:
+      typedef decltype(test<State>(nullptr)) type;
+      static const bool value = type::value;
+  };
+
+  /** @brief Cache of nodes of policies which do not implement
+   * [mcts::CachePolicy] */
+  struct NoCache {};
+
+  /** @brief type is Policy::Cache if Policy implements [mcts::CachePolicy],
+   * NoCache otherwise */
+  template<typename Policy> class policy_cache
+  {
+      template<typename P> static typename P::Cache test(typename P::Cache *);
+      template<typename P> static NoCache test(...);
+    public:
+      typedef decltype(test<Policy>(nullptr)) type;
+  };
+
+  /** @brief std::true_type iff Policy implements [mcts::ParallelPolicy],
+   * i.e. has merge */
+  template<typename Policy> class is_parallel_policy
+  {
+      template<typename P> static std::true_type test(decltype(
+            std::declval<P &>().merge(
+              std::declval<typename P::Payload &>(),
+              std::declval<const typename P::Payload &>())) *);
+      template<typename P> static std::false_type test(...);
+    public:
+      typedef decltype(test<Policy>(nullptr)) type;
+      static const bool value = type::value;
+  };
+
   /** @brief Generic Monte Carlo Tree object, needs [mcts::Policy] for search
    * strategy and [mcts::State] for domain dependency
+   *
+   * Nodes live in an Arena, the children of a node in one block allocated
+   * on expansion. apply() copies the part of the tree kept to a second
+   * arena, in depth-first order, and releases the old one in bulk, so Move
+   * and Payload must be trivially destructible.
+   *
+   * Search is sequential unless set otherwise by parallel().
+   *
+   * With transpositions() enabled, nodes of equal states (by
+   * HashState::hash) share their statistics through a TranspositionTable,
+   * so the tree is a DAG as far as statistics go. The table holds
+   * estimates of the cost to go, each node adds the cost of its own path
+   * (HashState::cost) to them when a playout passes through it.
+   *
+   * With widening() enabled, a node shows only the first of its moves,
+   * more as it gets visits. The block of children is regrown to twice the
+   * size when full, and the old block is left in the arena until apply().
    */
   template<typename State, typename Policy> class MonteCarloTree
   {
@@ -35,6 +289,8 @@ namespace mcts
       FRIEND_TEST(MonteCarloTreeTests, Tree);
       typedef typename State::Move Move;
       typedef typename Policy::Payload Payload;
+      typedef TranspositionTable<Payload> Table;
+      typedef typename policy_cache<Policy>::type Cache;
     public:
       class Node
       {
@@ -43,84 +299,526 @@ namespace mcts
           FRIEND_TEST(MonteCarloTreeTests, Tree);
         private:
           const Move move_;
-          std::vector<std::unique_ptr<Node> > children_;
+          /** @brief block of capacity_ children in the arena, the first
+           * size_ of them visible */
+          Node *children_;
+          size_t size_, capacity_;
+          /** @brief the block holds children of all the moves */
+          bool complete_;
+          /** @brief statistics of the node, for a shared node its view of
+           * the shared entry, see: pull */
           Payload payload_;
+          /** @brief entry shared with the nodes of equal states, which
+           * holds their statistics less offset_, the cost of the moves
+           * to the node; nullptr if not shared */
+          typename Table::Entry *shared_;
+          Fitness offset_;
+          Cache cache_;
+          /** @brief in parallel search guards payloads of the children,
+           * children_ and size_ */
+          std::atomic<bool> lock_;
 
         public:
           Node& operator=(const Node& other) = delete;
           explicit Node(const Node& other) = delete;
 
-          Node() : move_() {}
+          Node() : move_(), children_(nullptr), size_(0), capacity_(0),
+            complete_(false), shared_(nullptr), offset_(0), cache_(),
+            lock_(false) {}
 
-          explicit Node(const Move& _move) : move_(_move) {}
+          explicit Node(const Move& _move) : move_(_move), children_(nullptr),
+            size_(0), capacity_(0), complete_(false), shared_(nullptr),
+            offset_(0), cache_(), lock_(false) {}
 
           Payload& operator()() { return payload_; }
           const Payload& operator()() const { return payload_; }
 
+          /** @brief the nodes share statistics, see: transpositions */
+          bool shared_with(const Node &other) const
+          { return shared_ && shared_ == other.shared_; }
+
+          /** @brief data of a [mcts::CachePolicy] */
+          Cache& cache() { return cache_; }
+          const Cache& cache() const { return cache_; }
+
           Node& operator[](ssize_t i) {
-            assert(i >= 0 && i < (ssize_t) children_.size());
-            return *children_[i].get();
+            assert(i >= 0 && i < (ssize_t) size_);
+            return children_[i];
           }
           const Node& operator[](ssize_t i) const {
-            assert(i >= 0 && i < (ssize_t) children_.size());
-            return *children_[i].get();
+            assert(i >= 0 && i < (ssize_t) size_);
+            return children_[i];
           }
 
           size_t best_child() const
           {
             size_t best = 0;
             for (size_t i = 0; i < size(); i++)
-              if (children_[i]->payload_ < children_[best]->payload_) best = i;
+              if (children_[i]() < children_[best]()) best = i;
             return best;
           }
 
-          size_t size() const { return children_.size(); }
+          size_t size() const { return size_; }
 
           const Move& move() const { return move_; }
 
-          bool is_leaf() const { return children_.empty(); }
+          bool is_leaf() const { return size_ == 0; }
 
-          void expand(State &state)
+          /** @brief creates children for state.moves() in one block of
+           * the arena, sharing payloads through table if given */
+          void expand(State &state, Arena<Node> &arena, Table *table = nullptr)
           {
             assert(is_leaf());
             auto moves = state.moves();
             assert(!moves.empty());
-            children_.resize(moves.size());
-            size_t i = 0;
-            for (auto m : moves) { children_[i++].reset(new Node(m)); }
+            children_ = arena.allocate(moves.size());
+            for (auto m : moves)
+            {
+              Node *child = new (children_ + size_++) Node(m);
+              if (table)
+                child->share(*table, state, typename is_hash_state<State>::type());
+            }
+            capacity_ = size_;
+            complete_ = true;
           }
 
-          Fitness playout(Policy &policy, State &state, size_t iteration,
+          /**
+           * @brief makes the first count children visible, requires
+           * [mcts::WideningState]; regrows the block of children to at
+           * least twice its capacity if needed, the new block starting with
+           * the old children
+           **/
+          void widen(State &state, Arena<Node> &arena, Table *table,
+              size_t count)
+          {
+            if (count > capacity_ && !complete_)
+            {
+              size_t wanted = std::max(count, 2 * capacity_);
+              auto moves = state.moves(wanted);
+              assert(moves.size() >= capacity_ && !moves.empty());
+              Node *block = arena.allocate(moves.size());
+              for (size_t i = 0; i < capacity_; i++)
+              {
+                assert(moves[i] == children_[i].move());
+                new (block + i) Node(children_[i].move_);
+                block[i].relocate(children_[i]);
+              }
+              for (size_t i = capacity_; i < moves.size(); i++)
+              {
+                Node *child = new (block + i) Node(moves[i]);
+                if (table)
+                  child->share(*table, state, typename is_hash_state<State>::type());
+              }
+              children_ = block;
+              capacity_ = moves.size();
+              complete_ = capacity_ < wanted;
+            }
+            size_ = std::max(size_, std::min(count, capacity_));
+          }
+
+          Fitness playout(Policy &policy, State &state, Arena<Node> &arena,
+              Table *table, const Widening &widening, size_t iteration,
               size_t level)
           {
-            if (is_leaf() && !state.is_terminal()
-                && policy.expand(*this, level))
+            pull(policy, typename is_hash_state<State>::type());
+            if (is_leaf() ? !state.is_terminal() && policy.expand(*this, level)
+                : size_ < capacity_ || !complete_)
             {
-              expand(state);
+              grow(state, arena, table, widening,
+                  typename is_widening_state<State>::type());
             }
             Fitness estimate;
             if (!is_leaf())
             {
               size_t chosen_idx = policy.choose(*this);
               assert(chosen_idx < size());
-              Node &chosen = *children_[chosen_idx].get();
-              state.apply(chosen.move());
-              estimate = chosen.playout(policy, state, iteration, level + 1);
+              Node &chosen = children_[chosen_idx];
+              estimate = chosen.apply_playout(policy, state, arena, table,
+                  widening, iteration, level + 1,
+                  typename is_undo_state<State>::type());
+              policy.update(*this, chosen_idx, estimate);
+            }
+            else
+            {
+              estimate = state.estimate_playout(policy.get_random());
+              policy.update(*this, (ssize_t) (-1), estimate);
+            }
+            push(policy, typename is_hash_state<State>::type());
+            return estimate;
+          }
+
+          /**
+           * @brief playout sharing the tree with other threads
+           * @param guard lock_ of the parent, which guards payload_
+           * @param loss virtual loss of the playout
+           **/
+          Fitness parallel_playout(Policy &policy, State &state,
+              Arena<Node> &arena, size_t level, std::atomic<bool> &guard,
+              Fitness loss)
+          {
+            Node *chosen = nullptr;
+            size_t chosen_idx = 0;
+            {
+              SpinGuard parent(guard), self(lock_);
+              if (is_leaf() && !state.is_terminal()
+                  && policy.expand(*this, level))
+              {
+                expand(state, arena);
+              }
+              if (!is_leaf())
+              {
+                chosen_idx = policy.choose(*this);
+                assert(chosen_idx < size());
+                chosen = &children_[chosen_idx];
+                policy.add_virtual_loss(*this, chosen_idx, loss);
+              }
+            }
+            Fitness estimate;
+            if (chosen)
+            {
+              estimate = chosen->apply_parallel_playout(policy, state, arena,
+                  level + 1, lock_, loss, typename is_undo_state<State>::type());
+              SpinGuard parent(guard), self(lock_);
+              policy.remove_virtual_loss(*this, chosen_idx, loss);
               policy.update(*this, chosen_idx, estimate);
             }
             else
             {
               estimate = state.estimate_playout(policy.get_random());
+              SpinGuard parent(guard);
               policy.update(*this, (ssize_t) (-1), estimate);
             }
             return estimate;
           }
+
+        private:
+          /** @brief expands a leaf */
+          void grow(State &state, Arena<Node> &arena, Table *table,
+              const Widening &, std::false_type)
+          {
+            if (is_leaf()) expand(state, arena, table);
+          }
+
+          /** @brief expands a leaf or widens a node, as set by widening */
+          void grow(State &state, Arena<Node> &arena, Table *table,
+              const Widening &widening, std::true_type)
+          {
+            if (!widening.enabled())
+            {
+              if (is_leaf()) expand(state, arena, table);
+              return;
+            }
+            size_t count = widening.children((*this)().visits);
+            if (count > size_) widen(state, arena, table, count);
+          }
+
+          /** @brief applies move() to state and continues the playout */
+          Fitness apply_playout(Policy &policy, State &state,
+              Arena<Node> &arena, Table *table, const Widening &widening,
+              size_t iteration, size_t level, std::false_type)
+          {
+            state.apply(move());
+            return playout(policy, state, arena, table, widening, iteration,
+                level);
+          }
+
+          /** @brief same, then reverts the move */
+          Fitness apply_playout(Policy &policy, State &state,
+              Arena<Node> &arena, Table *table, const Widening &widening,
+              size_t iteration, size_t level, std::true_type)
+          {
+            auto undo = state.apply(move());
+            Fitness estimate = playout(policy, state, arena, table, widening,
+                iteration, level);
+            state.undo(undo);
+            return estimate;
+          }
+
+          /** @brief takes over the subtree and statistics of from, a
+           * node of the same move about to be abandoned */
+          void relocate(const Node &from)
+          {
+            children_ = from.children_;
+            size_ = from.size_;
+            capacity_ = from.capacity_;
+            complete_ = from.complete_;
+            payload_ = from.payload_;
+            shared_ = from.shared_;
+            offset_ = from.offset_;
+            cache_ = from.cache_;
+          }
+
+          Fitness apply_parallel_playout(Policy &policy, State &state,
+              Arena<Node> &arena, size_t level, std::atomic<bool> &guard,
+              Fitness loss, std::false_type)
+          {
+            state.apply(move());
+            return parallel_playout(policy, state, arena, level, guard, loss);
+          }
+
+          Fitness apply_parallel_playout(Policy &policy, State &state,
+              Arena<Node> &arena, size_t level, std::atomic<bool> &guard,
+              Fitness loss, std::true_type)
+          {
+            auto undo = state.apply(move());
+            Fitness estimate =
+              parallel_playout(policy, state, arena, level, guard, loss);
+            state.undo(undo);
+            return estimate;
+          }
+
+          /** @brief shares the payload of the state after move() in state
+           * through table */
+          void share(Table &table, const State &state, std::true_type)
+          {
+            bool inserted;
+            shared_ = table.find_or_insert(state.hash(move()), inserted);
+            offset_ = state.cost(move());
+          }
+
+          void share(Table &table, const State &state, std::false_type) {}
+
+          /** @brief updates payload_ with the statistics of all the nodes
+           * sharing its entry; they are kept as estimates of the cost to
+           * go, as the costs of the moves to equal states differ */
+          void pull(Policy &policy, std::true_type)
+          {
+            if (!shared_) return;
+            payload_ = shared_->payload;
+            policy.shift(payload_, offset_);
+          }
+
+          void pull(Policy &, std::false_type) {}
+
+          /** @brief stores payload_, updated after pull, to the entry */
+          void push(Policy &policy, std::true_type)
+          {
+            if (!shared_) return;
+            shared_->payload = payload_;
+            policy.shift(shared_->payload, -offset_);
+          }
+
+          void push(Policy &, std::false_type) {}
+
+          /** @brief moves shared payloads of the subtree back to the nodes */
+          void unshare(Policy &policy)
+          {
+            pull(policy, typename is_hash_state<State>::type());
+            shared_ = nullptr;
+            for (size_t i = 0; i < capacity_; i++) children_[i].unshare(policy);
+          }
+
+          /** @brief copies the cache and the payload of from, and its
+           * shared entry to table if from has one and table is given */
+          void copy_payload(const Node &from, Table *table)
+          {
+            cache_ = from.cache_;
+            payload_ = from.payload_;
+            if (!from.shared_ || !table) return;
+            bool inserted;
+            shared_ = table->find_or_insert(from.shared_->key, inserted);
+            offset_ = from.offset_;
+            if (shared_ && inserted) shared_->payload = from.shared_->payload;
+          }
+
+          /** @brief copies the children of from, recursively, to arena */
+          void copy_children(const Node &from, Arena<Node> &arena,
+              Table *table)
+          {
+            assert(is_leaf());
+            if (!from.capacity_) return;
+            children_ = arena.allocate(from.capacity_);
+            for (; capacity_ < from.capacity_; capacity_++)
+            {
+              const Node &child = from.children_[capacity_];
+              new (children_ + capacity_) Node(child.move_);
+              children_[capacity_].copy_payload(child, table);
+              children_[capacity_].copy_children(child, arena, table);
+            }
+            size_ = from.size_;
+            complete_ = from.complete_;
+          }
       };
 
+      static_assert(std::is_trivially_destructible<Node>::value,
+          "nodes are released in bulk, without destructors");
+
     private:
       Policy policy_;
-      std::unique_ptr<Node> root_;  // does not hold any move in fact
+      /** @brief nodes of the tree and storage of the next apply() */
+      Arena<Node> arena_, spare_;
+      Node *root_;  // does not hold any move in fact
       State root_state_;
+      /** @brief shared payloads of the tree and of the next apply(),
+       * nullptr unless transpositions() are enabled */
+      std::unique_ptr<Table> table_, spare_table_;
+
+      ParallelEnum parallel_;
+      /** @brief policies of the threads other than the calling one */
+      std::vector<Policy> policies_;
+      /** @brief kRootParallel: trees of the other threads */
+      std::vector<std::unique_ptr<MonteCarloTree> > trees_;
+      /** @brief kTreeParallel: nodes expanded by the other threads, until
+       * apply() moves them to arena_ */
+      std::vector<Arena<Node> > arenas_;
+      Widening widening_;
+
+      /** @brief expands the root, a leaf */
+      void expand_root()
+      {
+        if (root_state_.is_terminal()) return;
+        if (widening_.enabled())
+          grow_root(typename is_widening_state<State>::type());
+        else
+          root_->expand(root_state_, arena_, table_.get());
+      }
+
+      void grow_root(std::false_type) {}
+
+      void grow_root(std::true_type)
+      {
+        root_->widen(root_state_, arena_, table_.get(),
+            widening_.children((*root_)().visits));
+      }
+
+      /** @brief playout on a copy of the root state */
+      Fitness root_playout(size_t iteration, std::false_type)
+      {
+        State state = root_state_;
+        return root_->playout(policy_, state, arena_, table_.get(),
+            widening_, iteration, 0);
+      }
+
+      /** @brief playout on the root state, reverted move by move */
+      Fitness root_playout(size_t iteration, std::true_type)
+      {
+        return root_->playout(policy_, root_state_, arena_, table_.get(),
+            widening_, iteration, 0);
+      }
+
+      /** @see transpositions */
+      void set_tables(size_t entries)
+      {
+        root_->unshare(policy_);
+        table_.reset(entries ? new Table(entries) : nullptr);
+        spare_table_.reset(entries ? new Table(entries) : nullptr);
+      }
+
+      /** @brief kTreeParallel playout on a copy of state */
+      Fitness tree_playout(Policy &policy, State &state, Arena<Node> &arena,
+          std::atomic<bool> &guard, Fitness loss, std::false_type)
+      {
+        State copy = state;
+        return root_->parallel_playout(policy, copy, arena, 0, guard, loss);
+      }
+
+      /** @brief kTreeParallel playout on state, which is the thread's copy
+       * of the root state */
+      Fitness tree_playout(Policy &policy, State &state, Arena<Node> &arena,
+          std::atomic<bool> &guard, Fitness loss, std::true_type)
+      {
+        return root_->parallel_playout(policy, state, arena, 0, guard, loss);
+      }
+
+      /** @brief runs worker(t) on threads t = 1..policies_.size() and on
+       * the calling thread as t = 0 */
+      template<typename Worker> void run_threads(Worker worker)
+      {
+        std::vector<std::thread> pool;
+        for (size_t t = 1; t <= policies_.size(); t++)
+          pool.push_back(std::thread(worker, t));
+        worker(0);
+        for (auto &thread : pool) thread.join();
+      }
+
+      /** @return index of the best child of the root after sequential
+       * search */
+      template<typename ProgressCtrl>
+      size_t search_sequential(ProgressCtrl &progress_ctrl)
+      {
+        size_t iteration = 0;
+        double progress = 0;
+        Fitness best = std::numeric_limits<Fitness>::infinity();
+        while ((progress = progress_ctrl.progress(best)) <= 1)
+        {
+          Fitness estimate = root_playout(iteration,
+              typename is_undo_state<State>::type());
+          best = std::min(best, estimate);
+          ++iteration;
+        }
+        return root_->best_child();
+      }
+
+      template<typename ProgressCtrl>
+      size_t search_best(ProgressCtrl &progress_ctrl, std::false_type)
+      {
+        return search_sequential(progress_ctrl);
+      }
+
+      template<typename ProgressCtrl>
+      size_t search_best(ProgressCtrl &progress_ctrl, std::true_type)
+      {
+        if (policies_.empty() || parallel_ == kSequential)
+          return search_sequential(progress_ctrl);
+        if (parallel_ == kRootParallel)
+          return search_root_parallel(progress_ctrl);
+        return search_tree_parallel(progress_ctrl);
+      }
+
+      template<typename ProgressCtrl>
+      size_t search_root_parallel(ProgressCtrl &progress_ctrl)
+      {
+        SharedProgress<ProgressCtrl> shared(progress_ctrl);
+        run_threads([&](size_t t)
+            {
+              MonteCarloTree &tree = t ? *trees_[t - 1] : *this;
+              size_t iteration;
+              Fitness loss;
+              while (shared.next(iteration, loss))
+                shared.done(tree.root_playout(iteration,
+                      typename is_undo_state<State>::type()));
+            });
+        size_t best_idx = 0;
+        Payload best;
+        for (size_t i = 0; i < root_->size(); i++)
+        {
+          Payload merged = root_->children_[i]();
+          for (auto &tree : trees_)
+          {
+            // with widening the trees may show different numbers of moves
+            if (i >= tree->root_->size()) continue;
+            assert(tree->root_->children_[i].move() ==
+                root_->children_[i].move());
+            policy_.merge(merged, tree->root_->children_[i]());
+          }
+          if (i == 0 || merged < best)
+          {
+            best = merged;
+            best_idx = i;
+          }
+        }
+        return best_idx;
+      }
+
+      template<typename ProgressCtrl>
+      size_t search_tree_parallel(ProgressCtrl &progress_ctrl)
+      {
+        SharedProgress<ProgressCtrl> shared(progress_ctrl);
+        std::atomic<bool> root_guard(false);
+        run_threads([&](size_t t)
+            {
+              Policy &policy = t ? policies_[t - 1] : policy_;
+              Arena<Node> &arena = t ? arenas_[t - 1] : arena_;
+              // copied once per playout if State cannot undo moves
+              State state = root_state_;
+              size_t iteration;
+              Fitness loss;
+              while (shared.next(iteration, loss))
+                shared.done(tree_playout(policy, state, arena, root_guard,
+                      loss, typename is_undo_state<State>::type()));
+            });
+        return root_->best_child();
+      }
 
     public:
       /** @brief Creates search tree with given [mcts::Policy] and
@@ -129,10 +827,10 @@ namespace mcts
        * @param policy a [mcts::Policy] determining tree behaviour
        **/
       MonteCarloTree(const State& state, const Policy &policy)
-        : policy_(policy), root_state_(state)
+        : policy_(policy), root_state_(state), parallel_(kSequential)
       {
-        root_.reset(new Node());
-        root_->expand(root_state_);
+        root_ = new (arena_.allocate(1)) Node();
+        expand_root();
       }
 
       /** @brief Performs search according to embedded [mcts::Policy],
@@ -142,19 +840,45 @@ namespace mcts
       template<typename ProgressCtrl>
       Move search(ProgressCtrl &progress_ctrl)
       {
-        size_t iteration = 0;
-        double progress = 0;
-        Fitness best = std::numeric_limits<Fitness>::infinity();
-        while ((progress = progress_ctrl.progress(best)) <= 1)
+        size_t best_idx = search_best(progress_ctrl,
+            typename is_parallel_policy<Policy>::type());
+        assert(best_idx < root_->size());
+        return root_->children_[best_idx].move();
+      }
+
+      /**
+       * @brief Makes search run on 1 + policies.size() threads, requires
+       * [mcts::ParallelPolicy]
+       * @param parallel kind of parallelism, see: ParallelEnum
+       * @param policies [implement mcts::ParallelPolicy] policies of the
+       * threads other than the calling one, each with its own Random
+       * ASSUMPTION: State::estimate_playout and State::moves may run
+       * concurrently on different states
+       **/
+      void parallel(ParallelEnum parallel, const std::vector<Policy> &policies)
+      {
+        static_assert(is_parallel_policy<Policy>::value,
+            "parallel search requires mcts::ParallelPolicy");
+        assert(!(table_ && parallel == kTreeParallel));
+        assert(!(widening_.enabled() && parallel == kTreeParallel));
+        parallel_ = parallel;
+        policies_.clear();
+        trees_.clear();
+        arenas_.clear();
+        for (auto &policy : policies)
         {
-          State state = root_state_;
-          Fitness estimate = root_->playout(policy_, state, iteration, 0);
-          best = std::min(best, estimate);
-          ++iteration;
+          policies_.push_back(policy);
+          if (parallel == kRootParallel)
+          {
+            trees_.emplace_back(new MonteCarloTree(root_state_, policy));
+            if (table_) trees_.back()->set_tables(table_->size());
+            if (widening_.enabled())
+              trees_.back()->widening(widening_.coefficient,
+                  widening_.exponent);
+          }
+          if (parallel == kTreeParallel)
+            arenas_.emplace_back();
         }
-        size_t best_idx = root_->best_child();
-        assert(best_idx < root_->size());
-        return root_->children_[best_idx]->move();
       }
 
       /** @brief Applies given [mcts::State::Move], removes inaccssible part of
@@ -163,22 +887,81 @@ namespace mcts
        **/
       void apply(const Move& move)
       {
-        for (auto &node : root_->children_)
+        spare_.clear();
+        if (spare_table_) spare_table_->clear();
+        Node *new_root = new (spare_.allocate(1)) Node(move);
+        // with widening the move may have no node yet
+        for (size_t i = 0; i < root_->capacity_; i++)
         {
-          if (move == node->move())
+          const Node &node = root_->children_[i];
+          if (move == node.move())
           {
-            Node* new_root = node.release();
-            root_.reset(new_root);  // this invokes old root destructor
-            root_state_.apply(move);
-            if (root_->is_leaf() && !root_state_.is_terminal())
-            {
-              root_->expand(root_state_);
-            }
+            new_root->copy_payload(node, spare_table_.get());
+            new_root->copy_children(node, spare_, spare_table_.get());
             break;
           }
         }
+        // releases the old tree
+        arena_.swap(spare_);
+        table_.swap(spare_table_);
+        for (auto &arena : arenas_) arena.clear();
+        root_ = new_root;
+        root_state_.apply(move);
+        if (root_->is_leaf()) expand_root();
+        for (auto &tree : trees_) tree->apply(move);
+      }
+
+      /**
+       * @brief Makes nodes of equal states share statistics, requires
+       * [mcts::HashState] and [mcts::ShiftPolicy]; not supported by
+       * kTreeParallel. Nodes expanded
+       * so far keep their own statistics. O(nodes).
+       * @param entries size of the transposition table, 0 disables it;
+       * the tree keeps two tables of this size
+       **/
+      void transpositions(size_t entries)
+      {
+        static_assert(is_hash_state<State>::value,
+            "transpositions require mcts::HashState");
+        assert(parallel_ != kTreeParallel || policies_.empty());
+        set_tables(entries);
+        for (auto &tree : trees_) tree->set_tables(entries);
       }
 
+      /**
+       * @brief Enables progressive widening, see: Widening; requires
+       * [mcts::WideningState] and Payload::visits, not supported by
+       * kTreeParallel. Discards the tree searched so far.
+       * @param coefficient 0 disables widening
+       **/
+      void widening(double coefficient, double exponent = .5)
+      {
+        static_assert(is_widening_state<State>::value,
+            "widening requires mcts::WideningState");
+        assert(parallel_ != kTreeParallel || policies_.empty());
+        widening_.coefficient = coefficient;
+        widening_.exponent = exponent;
+        arena_.clear();
+        if (table_) table_->clear();
+        root_ = new (arena_.allocate(1)) Node();
+        expand_root();
+        for (auto &tree : trees_) tree->widening(coefficient, exponent);
+      }
+
+      /** @return number of nodes in the tree, of the calling thread's tree
+       * for kRootParallel; with widening also of hidden children and of
+       * blocks regrown since the last apply() */
+      size_t nodes() const
+      {
+        size_t total = arena_.allocated();
+        for (auto &arena : arenas_) total += arena.allocated();
+        return total;
+      }
+
+      /** @brief Root node accessor, of the calling thread's tree for
+       * kRootParallel */
+      const Node &root() const { return *root_; }
+
       /** @brief Root statee accessor
        * @returns reference to the root state
        **/
@@ -1,8 +1,12 @@
 #ifndef MCTS_POLICY_H_
 #define MCTS_POLICY_H_
 
+#include <cassert>
+#include <cmath>
+#include <cstdint>
 #include <limits>
 #include <algorithm>
+#include <vector>
 
 namespace mcts
 {
@@ -26,21 +30,93 @@ namespace mcts
     template<typename Node>
     void update(Node &node, size_t index, double fitness);
   };
+
+  parallel search also requires [mcts::ParallelPolicy] (see:
+  MonteCarloTree.h), implemented by the policies below
   */
 
+  /** @return natural logarithm of n, 0 for n = 0; looked up in a table for
+   * n < 2^16 */
+  inline double tabulated_log(size_t n)
+  {
+    static const size_t kSize = 1 << 16;
+    static const std::vector<double> table = []
+    {
+      std::vector<double> t(kSize, 0);
+      for (size_t i = 1; i < kSize; i++) t[i] = std::log(i);
+      return t;
+    }();
+    return n < kSize ? table[n] : std::log(n);
+  }
+
+  /** @brief playouts in progress through a node, see: VirtualLoss */
+  struct Pending
+  {
+    size_t pending = 0;
+    Fitness pending_sum = 0;
+
+    /** @return mean of visits estimates with the given mean and of the
+     * virtual losses of the pending playouts */
+    Fitness with_pending(Fitness mean, size_t visits) const
+    {
+      return pending && visits ?
+        (mean * visits + pending_sum) / (visits + pending) : mean;
+    }
+  };
+
+  /** @brief [partial mcts::ParallelPolicy]
+   * virtual losses of a Payload derived from Pending
+   */
+  struct VirtualLoss
+  {
+    template<typename Node>
+    void add_virtual_loss(Node &node, size_t chosen, Fitness loss)
+    {
+      Pending &p = node[chosen]();
+      p.pending++;
+      p.pending_sum += loss;
+    }
+
+    template<typename Node>
+    void remove_virtual_loss(Node &node, size_t chosen, Fitness loss)
+    {
+      Pending &p = node[chosen]();
+      assert(p.pending);
+      // exactly 0 when nothing is pending, whatever the rounding
+      p.pending_sum = --p.pending ? p.pending_sum - loss : 0;
+    }
+  };
+
   /** @brief [partial mcts::Policy]
    * maintains mean estimate in the Payload
    */
-  struct Mean
+  struct Mean : VirtualLoss
   {
-    struct Payload
+    struct Payload : Pending
     {
       size_t visits = 0;
       Fitness estimate = std::numeric_limits<Fitness>::infinity();
       bool operator<(const Payload &b) const
-      { return estimate < b.estimate; }
+      {
+        return with_pending(estimate, visits) <
+          b.with_pending(b.estimate, b.visits);
+      }
     };
 
+    void shift(Payload &payload, Fitness offset)
+    {
+      if (payload.visits) payload.estimate += offset;
+    }
+
+    void merge(Payload &into, const Payload &from)
+    {
+      if (!from.visits) return;
+      into.estimate = !into.visits ? from.estimate :
+        (into.estimate * into.visits + from.estimate * from.visits) /
+        (into.visits + from.visits);
+      into.visits += from.visits;
+    }
+
     template<typename Node>
     void update(Node &node, ssize_t chosen, Fitness estimate)
     {
@@ -109,13 +185,14 @@ namespace mcts
    * With probability eps chooses child at random,
    * otherwise best child until now.
    */
-  template<typename Random> struct PolicyEpsBest : VisitsMin
+  template<typename Random> struct PolicyEpsBest : VisitsMin, VirtualLoss
   {
     private:
       Random& random_;
       double eps;
     public:
-      struct Payload
+      /** @brief virtual losses do not change the best estimate */
+      struct Payload : Pending
       {
         size_t visits = 0;
         Fitness estimate = std::numeric_limits<Fitness>::infinity();
@@ -143,6 +220,24 @@ namespace mcts
         }
       }
 
+      void shift(Payload &payload, Fitness offset)
+      {
+        if (!payload.visits) return;
+        payload.estimate += offset;
+        payload.best_estimate += offset;
+      }
+
+      void merge(Payload &into, const Payload &from)
+      {
+        into.visits += from.visits;
+        into.estimate = std::min(into.estimate, from.estimate);
+        if (from.best_estimate < into.best_estimate)
+        {
+          into.best_estimate = from.best_estimate;
+          into.best_child = from.best_child;
+        }
+      }
+
       template<typename Node> size_t choose(const Node &node)
       {
         return (node.size() > node().best_child ||
@@ -154,21 +249,24 @@ namespace mcts
   /** @brief [implements mcts::Policy]
    * Best child is ??
    */
-  template<typename Random> struct PolicyMuSigma : VisitsMin
+  template<typename Random> struct PolicyMuSigma : VisitsMin, VirtualLoss
   {
     private:
       Random &random_;
       double discovery_factor_;
 
     public:
-      struct Payload
+      struct Payload : Pending
       {
         size_t visits = 0;
         double mean = 0;
         double interm = 0;
         double factor = 0;
         bool operator<(const Payload &b) const
-        { return factor < b.factor; }
+        {
+          return factor + (with_pending(mean, visits) - mean) <
+            b.factor + (b.with_pending(b.mean, b.visits) - b.mean);
+        }
       };
 
       explicit PolicyMuSigma(
@@ -190,9 +288,211 @@ namespace mcts
             discovery_factor_ * sqrt(p.interm / (p.visits - 1)));
       }
 
+      void shift(Payload &payload, Fitness offset)
+      {
+        if (!payload.visits) return;
+        payload.mean += offset;
+        payload.factor += offset;
+      }
+
+      void merge(Payload &into, const Payload &from)
+      {
+        if (!from.visits) return;
+        // http://en.wikipedia.org/wiki/Algorithms_for_calculating_variance#Parallel_algorithm
+        double visits = into.visits + from.visits;
+        double delta = from.mean - into.mean;
+        into.mean += delta * from.visits / visits;
+        into.interm += from.interm +
+          delta * delta * into.visits * from.visits / visits;
+        into.visits += from.visits;
+        into.factor = into.mean + (into.visits <= 1 ? 0 :
+            discovery_factor_ * sqrt(into.interm / (into.visits - 1)));
+      }
+
       template<typename Node> size_t choose(const Node &node)
       { return node.best_child(); }
   };
+
+  /** @brief [implements mcts::Policy, mcts::CachePolicy]
+   * UCB1-Tuned: chooses the child with the lowest confidence bound
+   *   mean - c * sqrt(ln N / n * min(R^2 / 4, var + R^2 * sqrt(2 ln N / n)))
+   * where N, n are visits of the node and the child and R is the range of
+   * the estimates seen by the node, in place of the [0, 1] range of
+   * rewards; unvisited children come first, in order.
+   * Best child is the one with the best mean estimate.
+   *
+   * The bounds are kept in a tournament tree over the children, in their
+   * Caches, computed with ln N of the last rebuild of the tree. A change to
+   * the statistics of a child, by update or by a virtual loss, replays only
+   * its path, so choose is O(log children) amortized instead of
+   * O(children); the tree is rebuilt once N grows by 1/8 or the node gets
+   * more children (see: MonteCarloTree::widening). Statistics of
+   * transpositions changed through other parents are seen at the next
+   * rebuild.
+   */
+  template<typename Random> struct PolicyUCT : VisitsMin
+  {
+    private:
+      Random &random_;
+      double exploration_;
+
+    public:
+      struct Payload : Pending
+      {
+        size_t visits = 0;
+        double mean = 0;
+        double interm = 0;
+        Fitness min = std::numeric_limits<Fitness>::infinity();
+        Fitness max = -std::numeric_limits<Fitness>::infinity();
+
+        /** @return mean including virtual losses, infinity if unvisited */
+        Fitness value() const
+        {
+          return visits ? with_pending(mean, visits) :
+            pending ? pending_sum / pending :
+            std::numeric_limits<Fitness>::infinity();
+        }
+
+        bool operator<(const Payload &b) const { return value() < b.value(); }
+      };
+
+      struct Cache
+      {
+        /** @brief bound of the node as a child, with ln N of the parent's
+         * last rebuild */
+        double bound = 0;
+        /** @brief winner of the match i of the parent's tournament tree,
+         * where i is the index of the node among its siblings */
+        uint32_t winner = 0;
+        /** @brief children and visits of the node at the last rebuild,
+         * 0 children if never built, and ln of the visits */
+        size_t built_size = 0, built_visits = 0;
+        double built_log = 0;
+      };
+
+      explicit PolicyUCT(
+        Random &_random, double exploration = 1.0, size_t _visits_min = 20)
+        : VisitsMin(_visits_min), random_(_random), exploration_(exploration)
+      {}
+
+      Random & get_random(){ return random_; }
+
+      template<typename Node> size_t choose(Node &node)
+      {
+        const Cache &c = node.cache();
+        if (c.built_size != node.size() ||
+            node().visits > c.built_visits + c.built_visits / 8)
+          build(node);
+        return winner(node, 1);
+      }
+
+      template<typename Node>
+      void update(Node &node, ssize_t chosen, Fitness estimate)
+      {
+        Payload &p = node();
+        p.visits++;
+        double delta = estimate - p.mean;
+        p.mean += delta / p.visits;
+        p.interm += delta * (estimate - p.mean);
+        p.min = std::min(p.min, estimate);
+        p.max = std::max(p.max, estimate);
+        if (chosen != -1) replay(node, chosen);
+      }
+
+      template<typename Node>
+      void add_virtual_loss(Node &node, size_t chosen, Fitness loss)
+      {
+        Payload &p = node[chosen]();
+        p.pending++;
+        p.pending_sum += loss;
+        replay(node, chosen);
+      }
+
+      template<typename Node>
+      void remove_virtual_loss(Node &node, size_t chosen, Fitness loss)
+      {
+        Payload &p = node[chosen]();
+        assert(p.pending);
+        // exactly 0 when nothing is pending, whatever the rounding
+        p.pending_sum = --p.pending ? p.pending_sum - loss : 0;
+        replay(node, chosen);
+      }
+
+      void shift(Payload &payload, Fitness offset)
+      {
+        if (!payload.visits) return;
+        payload.mean += offset;
+        payload.min += offset;
+        payload.max += offset;
+      }
+
+      void merge(Payload &into, const Payload &from)
+      {
+        if (!from.visits) return;
+        // http://en.wikipedia.org/wiki/Algorithms_for_calculating_variance#Parallel_algorithm
+        double visits = into.visits + from.visits;
+        double delta = from.mean - into.mean;
+        into.mean += delta * from.visits / visits;
+        into.interm += from.interm +
+          delta * delta * into.visits * from.visits / visits;
+        into.visits += from.visits;
+        into.min = std::min(into.min, from.min);
+        into.max = std::max(into.max, from.max);
+      }
+
+      /** @return confidence bound of node[i] for ln N = log */
+      template<typename Node> double bound(const Node &node, size_t i,
+          double log) const
+      {
+        const Payload &c = node[i]();
+        size_t n = c.visits + c.pending;
+        if (!n) return -std::numeric_limits<double>::infinity();
+        double range = node().max - node().min;
+        double range2 = std::isfinite(range) ? range * range : 0;
+        double var = c.visits ? c.interm / c.visits : 0;
+        double e = log / n;
+        return c.value() - exploration_ *
+          sqrt(e * std::min(range2 / 4, var + range2 * sqrt(2 * e)));
+      }
+
+    private:
+      // match i < size has players 2i and 2i + 1; player j >= size is the
+      // child j - size, player j < size the winner of match j
+
+      template<typename Node> size_t winner(const Node &node, size_t j) const
+      {
+        return j >= node.size() ? j - node.size() : node[j].cache().winner;
+      }
+
+      /** @brief ties go to the lower index, e.g. among unvisited */
+      template<typename Node> void play(Node &node, size_t i)
+      {
+        size_t a = winner(node, 2 * i), b = winner(node, 2 * i + 1);
+        double bound_a = node[a].cache().bound, bound_b = node[b].cache().bound;
+        node[i].cache().winner =
+          bound_b < bound_a || (bound_b == bound_a && b < a) ? b : a;
+      }
+
+      /** @brief rebounds all the children, O(children) */
+      template<typename Node> void build(Node &node)
+      {
+        Cache &c = node.cache();
+        c.built_size = node.size();
+        c.built_visits = node().visits;
+        c.built_log = tabulated_log(c.built_visits);
+        for (size_t i = 0; i < node.size(); i++)
+          node[i].cache().bound = bound(node, i, c.built_log);
+        for (size_t i = node.size() - 1; i > 0; i--) play(node, i);
+      }
+
+      /** @brief rebounds node[i] and replays its matches, O(log children) */
+      template<typename Node> void replay(Node &node, size_t i)
+      {
+        if (node.cache().built_size != node.size()) return;
+        node[i].cache().bound = bound(node, i, node.cache().built_log);
+        for (size_t j = (i + node.size()) / 2; j > 0; j /= 2) play(node, j);
+      }
+  };
 }  // namespace mcts
 
 #endif  // MCTS_POLICY_H_
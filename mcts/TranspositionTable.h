@@ -0,0 +1,116 @@
+#ifndef MCTS_TRANSPOSITIONTABLE_H_
+#define MCTS_TRANSPOSITIONTABLE_H_
+
+// http://en.wikipedia.org/wiki/Transposition_table
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+
+namespace mcts
+{
+  /** @brief 64-bit mixing function (splitmix64), e.g. for Zobrist keys
+   * computed on demand instead of drawn and stored */
+  inline uint64_t mix64(uint64_t x)
+  {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+
+  /**
+   * @brief fixed-size hash table of Payloads shared by all states with the
+   * same hash
+   *
+   * Open addressing with linear probing over at most kProbes entries; an
+   * entry is claimed by a compare-and-swap of its key, so find_or_insert
+   * may be called concurrently and never blocks. Entries are never
+   * removed, only the whole table is cleared.
+   */
+  template<typename Payload> class TranspositionTable
+  {
+    public:
+      static const size_t kProbes = 8;
+
+      struct Entry
+      {
+        Entry() : key(0) {}
+        /** @brief hash of the states, 0 for free entries */
+        std::atomic<uint64_t> key;
+        Payload payload;
+      };
+
+      /** @param entries number of entries, rounded up to a power of 2 */
+      explicit TranspositionTable(size_t entries)
+      {
+        for (size_ = 1; size_ < entries; size_ *= 2) {}
+        entries_.reset(new Entry[size_]);
+        used_ = 0;
+      }
+
+      TranspositionTable(const TranspositionTable &) = delete;
+      TranspositionTable & operator=(const TranspositionTable &) = delete;
+
+      /**
+       * @return entry of the hash, nullptr if its probes are taken by other
+       *         hashes
+       * @param inserted set iff the entry was free
+       */
+      Entry * find_or_insert(uint64_t hash, bool &inserted)
+      {
+        // 0 marks free entries
+        hash += !hash;
+        inserted = false;
+        for (size_t i = 0; i < kProbes; i++)
+        {
+          Entry &entry = entries_[(hash + i) & (size_ - 1)];
+          uint64_t key = entry.key.load(std::memory_order_acquire);
+          if (!key)
+          {
+            if (entry.key.compare_exchange_strong(key, hash,
+                  std::memory_order_acq_rel))
+            {
+              inserted = true;
+              used_++;
+              return &entry;
+            }
+          }
+          if (key == hash) return &entry;
+        }
+        return nullptr;
+      }
+
+      /** @brief frees all entries and resets their payloads; O(size) */
+      void clear()
+      {
+        if (!used_) return;
+        for (size_t i = 0; i < size_; i++)
+        {
+          entries_[i].key.store(0, std::memory_order_relaxed);
+          entries_[i].payload = Payload();
+        }
+        used_ = 0;
+      }
+
+      /** @return number of entries in use */
+      size_t used() const
+      {
+        return used_;
+      }
+
+      /** @return number of entries */
+      size_t size() const
+      {
+        return size_;
+      }
+
+    private:
+      std::unique_ptr<Entry[]> entries_;
+      size_t size_;
+      std::atomic<size_t> used_;
+  };
+}  // namespace mcts
+
+#endif  // MCTS_TRANSPOSITIONTABLE_H_
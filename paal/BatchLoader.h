@@ -0,0 +1,168 @@
+#ifndef PAAL_BATCHLOADER_H_
+#define PAAL_BATCHLOADER_H_
+
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>  // NOLINT
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+namespace paal
+{
+  /**
+   * @brief loads a batch of instances on a pool of threads, handing them
+   * out in order through a bounded window.
+   *
+   * Instance i is loaded by load(i) on one of the threads. next() returns
+   * instances in the order of their indices, waiting only if the instance
+   * has not been loaded yet, so while the caller solves instance i, the
+   * instances up to i + window - 1 are being loaded. At most window
+   * instances are loaded and not yet returned at any time, which bounds the
+   * memory held by the batch.
+   *
+   * An exception thrown by load(i) is rethrown by the next() call that
+   * would return instance i; the loading of other instances goes on.
+   *
+   * Example:
+   * @code
+   *   BatchLoader<Matrix> loader(files.size(), [&](size_t i)
+   *     { return std::unique_ptr<Matrix>(new Matrix(files[i])); });
+   *   while (auto matrix = loader.next()) solve(*matrix);
+   * @endcode
+   * @param Instance type of the loaded instances, need not be copyable
+   */
+  template<typename Instance> class BatchLoader
+  {
+    public:
+      typedef std::unique_ptr<Instance> Pointer;
+      typedef std::function<Pointer(size_t)> Load;
+
+      /**
+       * @param count number of instances in the batch
+       * @param load thread-safe function returning the loaded instance i
+       * @param threads number of loading threads; 0 means one per hardware
+       *        thread
+       * @param window maximal number of instances loaded ahead; 0 means two
+       *        per thread
+       */
+      BatchLoader(size_t count, Load load, size_t threads = 0,
+          size_t window = 0) :
+        count_(count), load_(load), next_load_(0), next_out_(0),
+        stop_(false)
+      {
+        if (!threads)
+          threads = std::max(1u, std::thread::hardware_concurrency());
+        threads = std::max<size_t>(1, std::min(threads, count));
+        window_ = window ? window : 2 * threads;
+        slots_.resize(std::min(window_, count));
+        for (size_t t = 0; t < threads; ++t)
+          pool_.push_back(std::thread([this]() { work(); }));
+      }
+
+      /** @brief stops loading, instances not returned yet are dropped */
+      ~BatchLoader()
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          stop_ = true;
+        }
+        space_.notify_all();
+        for (auto &t : pool_) t.join();
+      }
+
+      BatchLoader(const BatchLoader &) = delete;
+      BatchLoader & operator=(const BatchLoader &) = delete;
+
+      /** @return number of instances in the batch */
+      size_t size() const
+      {
+        return count_;
+      }
+
+      /** @return index of the instance the next call to next() returns */
+      size_t position() const
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return next_out_;
+      }
+
+      /**
+       * @brief waits for the next instance in order
+       * @return the instance, nullptr after the last one
+       * @throws whatever load threw for this instance
+       */
+      Pointer next()
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (next_out_ == count_) return Pointer();
+        Slot &slot = slots_[next_out_ % slots_.size()];
+        ready_.wait(lock, [&]() { return slot.done; });
+        Pointer instance(std::move(slot.instance));
+        std::exception_ptr error = slot.error;
+        slot = Slot();
+        ++next_out_;
+        lock.unlock();
+        space_.notify_one();
+        if (error) std::rethrow_exception(error);
+        return instance;
+      }
+
+    private:
+      struct Slot
+      {
+        Slot() : done(false) {}
+        Pointer instance;
+        std::exception_ptr error;
+        bool done;
+      };
+
+      void work()
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true)
+        {
+          space_.wait(lock, [&]()
+              { return stop_ || next_load_ == count_ ||
+                next_load_ < next_out_ + window_; });
+          if (stop_ || next_load_ == count_) return;
+          size_t i = next_load_++;
+          lock.unlock();
+          Slot loaded;
+          try
+          {
+            loaded.instance = load_(i);
+          }
+          catch (...)
+          {
+            loaded.error = std::current_exception();
+          }
+          loaded.done = true;
+          lock.lock();
+          slots_[i % slots_.size()] = std::move(loaded);
+          ready_.notify_all();
+        }
+      }
+
+      const size_t count_;
+      Load load_;
+      size_t window_;
+      /** @brief instance i is kept in slots_[i % slots_.size()] from the
+       * moment it is loaded until next() returns it */
+      std::vector<Slot> slots_;
+      /** @brief index of the next instance to load and to return */
+      size_t next_load_, next_out_;
+      bool stop_;
+      mutable std::mutex mutex_;
+      /** @brief signalled when an instance is loaded */
+      std::condition_variable ready_;
+      /** @brief signalled when next() frees a slot, or on stop */
+      std::condition_variable space_;
+      std::vector<std::thread> pool_;
+  };
+}  // namespace paal
+
+#endif  // PAAL_BATCHLOADER_H_
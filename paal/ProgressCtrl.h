@@ -104,6 +104,26 @@ namespace paal
       return progress_;  // TODO(pompon): add linear interpolation if needed
     }
   };
+
+  /** @brief [implements ProgressCtrl] stops as soon as the walker converges,
+   * otherwise progress is given by the wrapped ProgressCtrl
+   *
+   * @param Walker [implements Walker] providing bool converged()
+   * @param ProgressCtrl [implements ProgressCtrl]
+   */
+  template<typename Walker, typename ProgressCtrl> struct ConvergenceCtrl
+  {
+    ConvergenceCtrl(const Walker &_walker, ProgressCtrl &_progress_ctrl) :
+      walker(_walker), progress_ctrl(_progress_ctrl) {}
+    const Walker &walker;
+    ProgressCtrl &progress_ctrl;
+
+    double progress(double current_fitness)
+    {
+      double p = progress_ctrl.progress(current_fitness);
+      return walker.converged() ? std::max(p, 1.) : p;
+    }
+  };
 }  // namespace paal
 
 #endif  // PAAL_PROGRESSCTRL_H_
@@ -0,0 +1,163 @@
+#ifndef PAAL_PARALLEL_SEARCH_H_
+#define PAAL_PARALLEL_SEARCH_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <limits>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "paal/search.h"
+
+namespace paal
+{
+  /**
+   * @brief slot publishing the best fitness reached by concurrently running
+   * searches, with a copy of the solution and the index of the walker
+   * that reached it.
+   *
+   * Only the fitness is lock-free: it is claimed by a compare-and-swap, so
+   * offers which do not improve it cost an atomic load and copy nothing.
+   * The winner of the swap then copies its solution into the slot under a
+   * mutex, unless a better one is already there, so the solution, and the
+   * walker index, are published under that mutex. While searches run,
+   * walker() and solution() may lag behind fitness(); they match it once
+   * the offers are done.
+   * @param Solution copyable
+   */
+  template<typename Solution> class BestSlot
+  {
+    public:
+      BestSlot() : fitness_(std::numeric_limits<double>::infinity()),
+        stored_(std::numeric_limits<double>::infinity()), walker_(0) {}
+
+      /**
+       * @brief publishes fitness of the solution reached by the given walker
+       * @param solution functor returning the solution (or a reference to
+       *   it); called under the mutex, only if fitness became the best
+       * @return true iff fitness became the global best
+       */
+      template<typename Get>
+      bool offer(double fitness, size_t walker, Get solution)
+      {
+        double best = fitness_.load(std::memory_order_relaxed);
+        while (fitness < best)
+          if (fitness_.compare_exchange_weak(best, fitness))
+          {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (fitness < stored_)
+            {
+              stored_ = fitness;
+              walker_ = walker;
+              solution_ = solution();
+            }
+            return true;
+          }
+        return false;
+      }
+
+      /** @return best fitness published so far */
+      double fitness() const { return fitness_.load(); }
+
+      /** @return index of the walker which published fitness() */
+      size_t walker() const
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return walker_;
+      }
+
+      /** @return copy of the solution of fitness() */
+      Solution solution() const
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return solution_;
+      }
+
+    private:
+      std::atomic<double> fitness_;
+      mutable std::mutex mutex_;
+      /** @brief fitness of solution_ */
+      double stored_;
+      size_t walker_;
+      Solution solution_;
+  };
+
+  /**
+   * @brief [implements Logger] publishes every logged fitness, with the
+   * solution of the walker, to a BestSlot
+   * @param Get functor returning the solution of the walker
+   */
+  template<typename Solution, typename Walker, typename Get>
+  struct BestSlotLogger
+  {
+    BestSlotLogger(BestSlot<Solution> &_slot, size_t _walker,
+        const Walker &_walker_ref, Get _get) :
+      slot(_slot), walker(_walker), walker_ref(_walker_ref), get(_get) {}
+    BestSlot<Solution> &slot;
+    size_t walker;
+    const Walker &walker_ref;
+    Get get;
+    void log(double current_fitness)
+    {
+      if (current_fitness < slot.fitness())
+        slot.offer(current_fitness, walker,
+            [this]() -> decltype(get(walker_ref)) { return get(walker_ref); });
+    }
+  };
+
+  /**
+   * @brief multi-start variant of search(): runs search() for every walker
+   * on a pool of threads.
+   *
+   * Walker i is driven by randoms[i], progress_ctrls[i] and step_ctrls[i],
+   * so every search has its own random stream and its own budget.
+   * Walkers are distributed among the threads dynamically.
+   *
+   * @param walkers [implement Walker] independent starting points
+   * @param randoms [implement Random] one per walker, seeded differently
+   * @param progress_ctrls [implement ProgressCtrl] one per walker
+   * @param step_ctrls [implement StepCtrl] one per walker
+   * @param best slot the searches publish their fitness to; on return it
+   *   holds the best fitness any walker reached during its search, which
+   *   need not be its final one, e.g. under Annealing, with its solution
+   * @param get functor returning the solution of a walker (or a const
+   *   reference to it), called with const Walker & under the mutex of best
+   *   whenever the walker improves the best fitness
+   * @param threads number of threads to use; 0 means one per hardware thread
+   * @return index of the walker which reached best.fitness()
+   */
+  template < typename Walker, typename Random, typename ProgressCtrl,
+           typename StepCtrl, typename Solution, typename Get >
+  size_t parallel_search(std::vector<Walker> &walkers,
+      std::vector<Random> &randoms, std::vector<ProgressCtrl> &progress_ctrls,
+      std::vector<StepCtrl> &step_ctrls, BestSlot<Solution> &best, Get get,
+      size_t threads = 0)
+  {
+    size_t n = walkers.size();
+    assert(n && randoms.size() == n && progress_ctrls.size() == n &&
+           step_ctrls.size() == n);
+    if (!threads) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, n);
+
+    std::atomic<size_t> next(0);
+    auto worker = [&]()
+    {
+      for (size_t i; (i = next++) < n;)
+      {
+        BestSlotLogger<Solution, Walker, Get> logger(best, i, walkers[i], get);
+        search(walkers[i], randoms[i], progress_ctrls[i], step_ctrls[i],
+            logger);
+      }
+    };
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < threads; ++t) pool.push_back(std::thread(worker));
+    worker();
+    for (auto &t : pool) t.join();
+    return best.walker();
+  }
+}  // namespace paal
+
+#endif  // PAAL_PARALLEL_SEARCH_H_
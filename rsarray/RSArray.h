@@ -18,9 +18,10 @@ namespace rsarray
   {
     typedef T value_type;
 
-    RSArray() : data_size(0), segments_size(0), segments_capacity(0) {}
+    RSArray() : data_size(0), segments_size(0), segments_capacity(0),
+      where_valid(false) {}
     template<typename Cycle> RSArray(const Cycle &cycle) :
-      data_size(0), segments_size(0), segments_capacity(0)
+      data_size(0), segments_size(0), segments_capacity(0), where_valid(false)
     {
       *this = cycle;
     }
@@ -39,7 +40,9 @@ namespace rsarray
 
     void resize(size_t n)
     {
+      where_valid = false;
       if (n == data_size) return;
+      where_.reset();
       data_.reset(new value_type[data_size = n]);
       // badalloc below will invalidate the object
       segments_.reset(new Segment[segments_capacity = sqrt(3 * n) + 2]);
@@ -79,13 +82,40 @@ namespace rsarray
      */
     void reduce()
     {
-      value_type A[data_size];
+      std::unique_ptr<value_type[]> A(new value_type[data_size]);
       for (size_t j = 0, s = 0; j < segments_size; ++j)
         for (size_t i = 0; i < segments_[j].size(); ++i)
           A[s++] = data_[segments_[j].get(i)];
-      for (size_t i = 0; i < data_size; ++i) data_[i] = A[i];
+      data_.swap(A);
       segments_size = 1;
       segments_[0] = Segment(0, data_size);
+      if (where_valid)
+        for (size_t i = 0; i < data_size; ++i) where_[data_[i]] = i;
+    }
+
+    /**
+     * @brief finds index of the given value
+     * O(sqrt(data_size)); O(data_size) after modification by operator[]
+     *
+     * ASSUMPTION: the array is a permutation of [0,data_size)
+     */
+    size_t position(const value_type &v)
+    {
+      if (!where_valid)
+      {
+        if (!where_) where_.reset(new size_t[data_size]);
+        for (size_t i = 0; i < data_size; ++i) where_[data_[i]] = i;
+        where_valid = true;
+      }
+      size_t d = where_[v];
+      for (size_t j = 0, s = 0;; s += segments_[j++].size())
+      {
+        const Segment &seg = segments_[j];
+        if (seg.begin < seg.end && seg.begin <= d && d < seg.end)
+          return s + d - seg.begin;
+        if (seg.end < seg.begin && seg.end <= d && d < seg.begin)
+          return s + seg.begin - 1 - d;
+      }
     }
 
     /**
@@ -114,6 +144,7 @@ namespace rsarray
 
     value_type & operator[](size_t i)
     {
+      where_valid = false;
       for (size_t j = 0, s = 0;; s += segments_[j++].size())
         if (i < s + segments_[j].size())
           return data_[segments_[j].get(i - s)];
@@ -134,6 +165,9 @@ namespace rsarray
     size_t data_size, segments_size, segments_capacity;
     std::unique_ptr<Segment[]> segments_;
     std::unique_ptr<value_type[]> data_;
+    /** @brief data_[where_[v]] == v, see: position */
+    std::unique_ptr<size_t[]> where_;
+    bool where_valid;
   };
 }  // namespace rsarray
 
@@ -0,0 +1,240 @@
+#ifndef SPATIAL_GRID_H_
+#define SPATIAL_GRID_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "tsp/util.h"
+
+namespace spatial
+{
+  /**
+   * @brief uniform grid over a set of points on the plane, answering
+   * nearest neighbour queries in expected O(k log k) for evenly spread
+   * points; points may be removed, see: remove
+   *
+   * Coordinates are copied in the order of cells, so a query reads
+   * contiguous memory, and queries issued in cell_order() mostly scan the
+   * same cells one after another.
+   */
+  struct Grid
+  {
+    /** @brief (squared distance, id) */
+    typedef std::pair<double, uint32_t> Neighbor;
+    static const uint32_t kNone = std::numeric_limits<uint32_t>::max();
+
+    Grid() : side_(0), live_(0) {}
+
+    /** @see build */
+    explicit Grid(const std::vector<tsp::Point> &pos, double per_cell = 2)
+    {
+      build(pos, per_cell);
+    }
+
+    /**
+     * @brief indexes pos; point ids are indices in pos
+     * @param per_cell expected number of points in a cell
+     */
+    void build(const std::vector<tsp::Point> &pos, double per_cell = 2)
+    {
+      size_t n = pos.size();
+      assert(n < kNone && per_cell > 0);
+      live_ = n;
+      lo_ = hi_ = n ? pos[0] : tsp::Point(0, 0);
+      for (const tsp::Point & p : pos)
+      {
+        lo_ = tsp::Point(std::min(lo_.x, p.x), std::min(lo_.y, p.y));
+        hi_ = tsp::Point(std::max(hi_.x, p.x), std::max(hi_.y, p.y));
+      }
+      side_ = std::max<size_t>(1, sqrt(n / per_cell));
+      cw_ = std::max((hi_.x - lo_.x) / side_, 1e-12);
+      ch_ = std::max((hi_.y - lo_.y) / side_, 1e-12);
+
+      // counting sort of points by cells
+      start_.assign(side_ * side_ + 1, 0);
+      for (const tsp::Point & p : pos) start_[cell(p) + 1]++;
+      for (size_t c = 0; c < side_ * side_; ++c) start_[c + 1] += start_[c];
+      count_.resize(side_ * side_);
+      for (size_t c = 0; c < side_ * side_; ++c)
+        count_[c] = start_[c + 1] - start_[c];
+      std::vector<uint32_t> fill(start_.begin(), start_.end() - 1);
+      ids_.resize(n);
+      slot_.resize(n);
+      for (size_t i = 0; i < n; ++i) ids_[slot_[i] = fill[cell(pos[i])]++] = i;
+      pts_.resize(n);
+      for (size_t b = 0; b < n; ++b) pts_[b] = pos[ids_[b]];
+    }
+
+    /** @return number of points not removed */
+    size_t size() const
+    {
+      return live_;
+    }
+
+    /** @brief ids of the indexed points by cells; points not removed come
+     * first in every cell */
+    const std::vector<uint32_t> & cell_order() const
+    {
+      return ids_;
+    }
+
+    /** @brief coordinates of the points of cell_order() */
+    const std::vector<tsp::Point> & cell_points() const
+    {
+      return pts_;
+    }
+
+    bool contains(uint32_t id) const
+    {
+      size_t b = slot_[id], c = cell(pts_[b]);
+      return b < start_[c] + count_[c];
+    }
+
+    /** @brief removes the point from the results of further queries; O(1) */
+    void remove(uint32_t id)
+    {
+      assert(contains(id));
+      size_t b = slot_[id], c = cell(pts_[b]);
+      size_t last = start_[c] + --count_[c];
+      std::swap(pts_[b], pts_[last]);
+      std::swap(ids_[b], ids_[last]);
+      slot_[ids_[b]] = b;
+      slot_[id] = last;
+      --live_;
+    }
+
+    /**
+     * @brief k nearest points to q, by increasing distance (ties by id)
+     * @param out vector to store the result in; shorter than k iff fewer
+     *        points are left
+     * @param skip id excluded from the result (e.g. the query point)
+     */
+    void knn(const tsp::Point &q, size_t k, std::vector<Neighbor> &out,
+        uint32_t skip = kNone) const
+    {
+      out.resize(k);
+      size_t found = 0;
+      if (!k || !live_)
+      {
+        out.clear();
+        return;
+      }
+      // raw pointers, as the compiler cannot tell out from the members
+      Neighbor *best = &out[0];
+      const tsp::Point *pts = &pts_[0];
+      const uint32_t *ids = &ids_[0];
+      ssize_t cx = cell_x(q), cy = cell_y(q), side = side_;
+      for (ssize_t r = 0;; ++r)
+      {
+        // ring of cells at Chebyshev distance r from (cx,cy)
+        for (ssize_t y = cy - r; y <= cy + r; ++y)
+        {
+          if (y < 0 || y >= side) continue;
+          ssize_t step = (y == cy - r || y == cy + r) ? 1 : 2 * r;
+          for (ssize_t x = cx - r; x <= cx + r; x += step)
+          {
+            if (x < 0 || x >= side) continue;
+            size_t c = y * side + x;
+            for (size_t b = start_[c], e = b + count_[c]; b < e; ++b)
+            {
+              if (ids[b] == skip) continue;
+              Neighbor nb((q - pts[b]).sqr(), ids[b]);
+              if (found == k && !(nb < best[found - 1])) continue;
+              size_t at = found < k ? found++ : found - 1;
+              for (; at && nb < best[at - 1]; --at) best[at] = best[at - 1];
+              best[at] = nb;
+            }
+          }
+        }
+        double reach = ring_reach(q, cx, cy, r);
+        if (reach == std::numeric_limits<double>::infinity()) break;
+        if (found == k && best[found - 1].first <= reach * reach) break;
+      }
+      out.resize(found);
+    }
+
+    /** @return nearest point to q, kNone if no point is left */
+    uint32_t nearest(const tsp::Point &q, uint32_t skip = kNone) const
+    {
+      std::vector<Neighbor> best;
+      knn(q, 1, best, skip);
+      return best.empty() ? kNone : best[0].second;
+    }
+
+    /** @brief ids of points at distance at most radius from q, unsorted */
+    void radius(const tsp::Point &q, double radius,
+        std::vector<uint32_t> &out) const
+    {
+      out.clear();
+      if (!live_) return;
+      size_t x0 = cell_x(tsp::Point(q.x - radius, q.y));
+      size_t x1 = cell_x(tsp::Point(q.x + radius, q.y));
+      size_t y0 = cell_y(tsp::Point(q.x, q.y - radius));
+      size_t y1 = cell_y(tsp::Point(q.x, q.y + radius));
+      for (size_t y = y0; y <= y1; ++y)
+        for (size_t x = x0; x <= x1; ++x)
+        {
+          size_t c = y * side_ + x;
+          for (size_t b = start_[c]; b < start_[c] + count_[c]; ++b)
+            if ((q - pts_[b]).sqr() <= radius * radius) out.push_back(ids_[b]);
+        }
+    }
+
+    private:
+      size_t cell_x(const tsp::Point &p) const
+      {
+        double x = (p.x - lo_.x) / cw_;
+        return x <= 0 ? 0 : std::min<size_t>(side_ - 1, x);
+      }
+
+      size_t cell_y(const tsp::Point &p) const
+      {
+        double y = (p.y - lo_.y) / ch_;
+        return y <= 0 ? 0 : std::min<size_t>(side_ - 1, y);
+      }
+
+      size_t cell(const tsp::Point &p) const
+      {
+        return cell_y(p) * side_ + cell_x(p);
+      }
+
+      /**
+       * @brief lower bound on the distance from q to points outside the
+       * rings up to r around its cell (cx,cy): the nearest side of the
+       * scanned box not lying on the grid border; infinity if the grid is
+       * covered
+       */
+      double ring_reach(const tsp::Point &q, ssize_t cx, ssize_t cy,
+          ssize_t r) const
+      {
+        ssize_t side = side_;
+        double reach = std::numeric_limits<double>::infinity();
+        if (cx - r > 0) reach = std::min(reach, q.x - lo_.x - (cx - r) * cw_);
+        if (cy - r > 0) reach = std::min(reach, q.y - lo_.y - (cy - r) * ch_);
+        if (cx + r < side - 1)
+          reach = std::min(reach, lo_.x + (cx + r + 1) * cw_ - q.x);
+        if (cy + r < side - 1)
+          reach = std::min(reach, lo_.y + (cy + r + 1) * ch_ - q.y);
+        return std::max(reach, 0.);
+      }
+
+      size_t side_, live_;
+      tsp::Point lo_, hi_;
+      /** @brief cell width and height */
+      double cw_, ch_;
+      /** @brief points of cell c are at [start_[c], start_[c] + count_[c])
+       * in pts_ and ids_ */
+      std::vector<uint32_t> start_, count_;
+      std::vector<uint32_t> ids_;
+      std::vector<tsp::Point> pts_;
+      /** @brief ids_[slot_[id]] == id */
+      std::vector<uint32_t> slot_;
+  };
+}  // namespace spatial
+
+#endif  // SPATIAL_GRID_H_
@@ -0,0 +1,257 @@
+#ifndef SPATIAL_KDTREE_H_
+#define SPATIAL_KDTREE_H_
+
+// http://en.wikipedia.org/wiki/K-d_tree
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "tsp/util.h"
+
+namespace spatial
+{
+  /**
+   * @brief 2-d tree over a set of points on the plane, answering nearest
+   * neighbour queries in O(log n) expected for most point sets, also
+   * clustered ones; points may be removed, see: remove
+   *
+   * Every node knows its bounding box and the number of points left in it,
+   * so emptied subtrees are skipped. Unlike Grid, queries stay fast while
+   * most points are removed, e.g. in nearest neighbour tours.
+   */
+  struct KDTree
+  {
+    /** @brief (squared distance, id) */
+    typedef std::pair<double, uint32_t> Neighbor;
+    static const uint32_t kNone = std::numeric_limits<uint32_t>::max();
+
+    KDTree() {}
+
+    /** @see build */
+    explicit KDTree(const std::vector<tsp::Point> &pos, size_t leaf_size = 8)
+    {
+      build(pos, leaf_size);
+    }
+
+    /**
+     * @brief indexes pos; point ids are indices in pos. O(n log n)
+     * @param leaf_size maximal number of points in a leaf
+     */
+    void build(const std::vector<tsp::Point> &pos, size_t leaf_size = 8)
+    {
+      size_t n = pos.size();
+      assert(n < kNone && leaf_size);
+      ids_.resize(n);
+      for (size_t i = 0; i < n; ++i) ids_[i] = i;
+      nodes_.clear();
+      nodes_.reserve(n ? 4 * (n / leaf_size + 1) : 0);
+      leaf_.resize(n);
+      if (n) build_node(pos, 0, n, kNone, leaf_size);
+      pts_.resize(n);
+      slot_.resize(n);
+      for (size_t b = 0; b < n; ++b)
+      {
+        pts_[b] = pos[ids_[b]];
+        slot_[ids_[b]] = b;
+      }
+    }
+
+    /** @return number of points not removed */
+    size_t size() const
+    {
+      return nodes_.empty() ? 0 : nodes_[0].live;
+    }
+
+    bool contains(uint32_t id) const
+    {
+      const Node &leaf = nodes_[leaf_[id]];
+      return slot_[id] < leaf.begin + leaf.live;
+    }
+
+    /** @brief removes the point from the results of further queries;
+     * O(depth) */
+    void remove(uint32_t id)
+    {
+      assert(contains(id));
+      uint32_t v = leaf_[id];
+      Node &leaf = nodes_[v];
+      size_t b = slot_[id], last = leaf.begin + leaf.live - 1;
+      std::swap(pts_[b], pts_[last]);
+      std::swap(ids_[b], ids_[last]);
+      slot_[ids_[b]] = b;
+      slot_[id] = last;
+      for (; v != kNone; v = nodes_[v].parent) --nodes_[v].live;
+    }
+
+    /**
+     * @brief k nearest points to q, by increasing distance (ties by id)
+     * @param out vector to store the result in; shorter than k iff fewer
+     *        points are left
+     * @param skip id excluded from the result (e.g. the query point)
+     */
+    void knn(const tsp::Point &q, size_t k, std::vector<Neighbor> &out,
+        uint32_t skip = kNone) const
+    {
+      out.resize(k);
+      size_t found = 0;
+      if (k && size()) knn_node(0, q, k, skip, out, found);
+      out.resize(found);
+    }
+
+    /** @return nearest point to q, kNone if no point is left */
+    uint32_t nearest(const tsp::Point &q, uint32_t skip = kNone) const
+    {
+      Neighbor best;
+      best.first = std::numeric_limits<double>::infinity();
+      best.second = kNone;
+      if (size()) nearest_node(0, q, skip, best);
+      return best.second;
+    }
+
+    /** @brief ids of points at distance at most radius from q, unsorted */
+    void radius(const tsp::Point &q, double radius,
+        std::vector<uint32_t> &out) const
+    {
+      out.clear();
+      if (size()) radius_node(0, q, radius * radius, out);
+    }
+
+    private:
+      struct Node
+      {
+        /** @brief bounding box of all points of the subtree */
+        tsp::Point lo, hi;
+        /** @brief points of the subtree are at [begin, end) in pts_, the
+         * ones not removed at [begin, begin + live) for leaves */
+        uint32_t begin, end, live;
+        /** @brief kNone for leaves */
+        uint32_t left, right;
+        uint32_t parent;
+      };
+
+      uint32_t build_node(const std::vector<tsp::Point> &pos,
+          uint32_t begin, uint32_t end, uint32_t parent, size_t leaf_size)
+      {
+        uint32_t v = nodes_.size();
+        nodes_.push_back(Node());
+        Node node;
+        node.lo = node.hi = pos[ids_[begin]];
+        for (uint32_t b = begin; b < end; ++b)
+        {
+          const tsp::Point &p = pos[ids_[b]];
+          node.lo = tsp::Point(std::min(node.lo.x, p.x),
+              std::min(node.lo.y, p.y));
+          node.hi = tsp::Point(std::max(node.hi.x, p.x),
+              std::max(node.hi.y, p.y));
+        }
+        node.begin = begin;
+        node.end = end;
+        node.live = end - begin;
+        node.left = node.right = kNone;
+        node.parent = parent;
+        if (end - begin <= leaf_size)
+        {
+          for (uint32_t b = begin; b < end; ++b) leaf_[ids_[b]] = v;
+        }
+        else
+        {
+          // median split along the longer side of the box
+          bool by_x = node.hi.x - node.lo.x >= node.hi.y - node.lo.y;
+          uint32_t mid = begin + (end - begin) / 2;
+          std::nth_element(ids_.begin() + begin, ids_.begin() + mid,
+              ids_.begin() + end, [&](uint32_t a, uint32_t b)
+              { return by_x ? pos[a].x < pos[b].x : pos[a].y < pos[b].y; });
+          node.left = build_node(pos, begin, mid, v, leaf_size);
+          node.right = build_node(pos, mid, end, v, leaf_size);
+        }
+        nodes_[v] = node;
+        return v;
+      }
+
+      /** @brief squared distance from q to the box of the node */
+      double box_sqr_distance(const Node &node, const tsp::Point &q) const
+      {
+        double dx = std::max(std::max(node.lo.x - q.x, q.x - node.hi.x), 0.);
+        double dy = std::max(std::max(node.lo.y - q.y, q.y - node.hi.y), 0.);
+        return dx * dx + dy * dy;
+      }
+
+      void knn_node(uint32_t v, const tsp::Point &q, size_t k, uint32_t skip,
+          std::vector<Neighbor> &out, size_t &found) const
+      {
+        const Node &node = nodes_[v];
+        if (!node.live) return;
+        if (found == k && box_sqr_distance(node, q) > out[found - 1].first)
+          return;
+        if (node.left == kNone)
+        {
+          for (uint32_t b = node.begin; b < node.begin + node.live; ++b)
+          {
+            if (ids_[b] == skip) continue;
+            Neighbor e((q - pts_[b]).sqr(), ids_[b]);
+            if (found == k && !(e < out[found - 1])) continue;
+            size_t at = found < k ? found++ : found - 1;
+            for (; at && e < out[at - 1]; --at) out[at] = out[at - 1];
+            out[at] = e;
+          }
+          return;
+        }
+        uint32_t near = node.left, far = node.right;
+        if (box_sqr_distance(nodes_[far], q) <
+            box_sqr_distance(nodes_[near], q)) std::swap(near, far);
+        knn_node(near, q, k, skip, out, found);
+        knn_node(far, q, k, skip, out, found);
+      }
+
+      void nearest_node(uint32_t v, const tsp::Point &q, uint32_t skip,
+          Neighbor &best) const
+      {
+        const Node &node = nodes_[v];
+        if (!node.live || box_sqr_distance(node, q) > best.first) return;
+        if (node.left == kNone)
+        {
+          for (uint32_t b = node.begin; b < node.begin + node.live; ++b)
+          {
+            Neighbor e((q - pts_[b]).sqr(), ids_[b]);
+            if (e < best && ids_[b] != skip) best = e;
+          }
+          return;
+        }
+        uint32_t near = node.left, far = node.right;
+        if (box_sqr_distance(nodes_[far], q) <
+            box_sqr_distance(nodes_[near], q)) std::swap(near, far);
+        nearest_node(near, q, skip, best);
+        nearest_node(far, q, skip, best);
+      }
+
+      void radius_node(uint32_t v, const tsp::Point &q, double sqr_radius,
+          std::vector<uint32_t> &out) const
+      {
+        const Node &node = nodes_[v];
+        if (!node.live || box_sqr_distance(node, q) > sqr_radius) return;
+        if (node.left == kNone)
+        {
+          for (uint32_t b = node.begin; b < node.begin + node.live; ++b)
+            if ((q - pts_[b]).sqr() <= sqr_radius) out.push_back(ids_[b]);
+          return;
+        }
+        radius_node(node.left, q, sqr_radius, out);
+        radius_node(node.right, q, sqr_radius, out);
+      }
+
+      std::vector<Node> nodes_;
+      /** @brief ids of points in the order of leaves, with coordinates */
+      std::vector<uint32_t> ids_;
+      std::vector<tsp::Point> pts_;
+      /** @brief ids_[slot_[id]] == id */
+      std::vector<uint32_t> slot_;
+      /** @brief leaf containing the point */
+      std::vector<uint32_t> leaf_;
+  };
+}  // namespace spatial
+
+#endif  // SPATIAL_KDTREE_H_
@@ -325,6 +325,11 @@ namespace splay {
         root_ = build_tree(array, 0, array.size());
       }
 
+      /** @brief takes ownership of the nodes; trees are not copyable */
+      SplayTree(SplayTree &&other) : root_(other.root_) {
+        other.root_ = NULL;
+      }
+
       ~SplayTree() {
         dispose_tree(root_);
       }
@@ -11,6 +11,9 @@
 #include <string>
 #include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <limits>
+#include <vector>
 
 template<typename State, typename Policy>
 mcts::MonteCarloTree<State, Policy>
@@ -36,7 +39,8 @@ typedef ::testing::Types <
     mcts::PolicyRandMean<Random>,
     mcts::PolicyEpsMean<Random>,
     mcts::PolicyEpsBest<Random>,
-    mcts::PolicyMuSigma<Random>
+    mcts::PolicyMuSigma<Random>,
+    mcts::PolicyUCT<Random>
   > PoliciesList;
 TYPED_TEST_CASE(MCTS_FLPolicy, PoliciesList);
 
@@ -58,3 +62,51 @@ TYPED_TEST(MCTS_FLPolicy, Performance_1011EuclS)
   std::cout << "samples: " << samples << " optimal cost: " << matrix.optimal_cost() << " res: " << mct.root_state().cost()
     << std::endl;
 }
+
+/** facilities and cities on a line, opening cost 1 */
+struct LineMatrix
+{
+  double operator()(size_t facility) const { return 1; }
+  double operator()(size_t facility, size_t city) const
+  { return std::fabs(double(facility) - double(city)) / 4; }
+};
+
+TEST(MCTS_FLState, undo)
+{
+  typedef facility_location::FLState<LineMatrix> State;
+  LineMatrix matrix;
+  State state(matrix, 1, 10, 10);
+  std::mt19937 random(38);
+  std::vector<State::Undo> undos;
+  std::vector<double> costs;
+  while (!state.is_terminal())
+  {
+    costs.push_back(state.cost());
+    // playouts leave the state unchanged
+    size_t left = state.left_decisions();
+    state.estimate_playout(random);
+    EXPECT_EQ(left, state.left_decisions());
+    EXPECT_EQ(costs.back(), state.cost());
+    undos.push_back(state.apply(random() % 2));
+  }
+  while (!undos.empty())
+  {
+    state.undo(undos.back());
+    undos.pop_back();
+    EXPECT_EQ(costs.back(), state.cost());
+    costs.pop_back();
+  }
+  EXPECT_EQ(10u, state.left_decisions());
+}
+
+TEST(MCTS_FLState, search)
+{
+  typedef facility_location::FLState<LineMatrix> State;
+  LineMatrix matrix;
+  State state(matrix, 1, 10, 10);
+  std::mt19937 random(512);
+  mcts::PolicyRandMean<std::mt19937> policy(random);
+  auto mct = run_mcts(state, policy, 100);
+  EXPECT_TRUE(mct.root_state().is_terminal());
+  EXPECT_LT(mct.root_state().cost(), std::numeric_limits<double>::infinity());
+}
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <set>
+#include <utility>
+
+#include "mcts/Arena.h"
+
+TEST(mcts_Arena, allocate)
+{
+  mcts::Arena<int64_t> arena(10);
+  std::set<int64_t *> blocks;
+  for (size_t n = 1; n <= 6; n++)
+  {
+    int64_t *block = arena.allocate(n);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(block) % alignof(int64_t));
+    for (size_t i = 0; i < n; i++) block[i] = n;
+    blocks.insert(block);
+  }
+  EXPECT_EQ(6u, blocks.size());
+  EXPECT_EQ(21u, arena.allocated());
+  // blocks do not overlap
+  for (int64_t *block : blocks)
+    for (int64_t i = 0; i < block[0]; i++) EXPECT_EQ(block[0], block[i]);
+
+  // larger than a chunk
+  int64_t *large = arena.allocate(25);
+  for (size_t i = 0; i < 25; i++) large[i] = -1;
+  EXPECT_EQ(46u, arena.allocated());
+  EXPECT_GE(arena.capacity(), 46u);
+}
+
+TEST(mcts_Arena, clear_reuses_chunks)
+{
+  mcts::Arena<int> arena(8);
+  int *first = arena.allocate(3);
+  arena.allocate(8);
+  arena.allocate(20);
+  size_t capacity = arena.capacity();
+  arena.clear();
+  EXPECT_EQ(0u, arena.allocated());
+  EXPECT_EQ(first, arena.allocate(3));
+  arena.allocate(8);
+  arena.allocate(20);
+  EXPECT_EQ(capacity, arena.capacity());
+}
+
+TEST(mcts_Arena, swap_and_move)
+{
+  mcts::Arena<int> a(4), b(4);
+  int *block = a.allocate(3);
+  a.swap(b);
+  EXPECT_EQ(0u, a.allocated());
+  EXPECT_EQ(3u, b.allocated());
+  mcts::Arena<int> c(std::move(b));
+  EXPECT_EQ(3u, c.allocated());
+  EXPECT_EQ(0u, b.capacity());
+  EXPECT_NE(block, b.allocate(2));
+  EXPECT_EQ(block + 3, c.allocate(1));
+}
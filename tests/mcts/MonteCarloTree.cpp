@@ -2,10 +2,13 @@
 
 #include <mcts/MonteCarloTree.h>
 #include <tsp/TSPLIB.h>
+#include <tsp/EuclidMatrix.h>
 #include <tsp/MCTS_tsp.h>
+#include <mcts/Policy.h>
 #include <paal/ProgressCtrl.h>
 
 #include <limits>
+#include <random>
 #include <vector>
 #include <utility>
 #include <algorithm>
@@ -67,7 +70,8 @@ TEST_F(MonteCarloTreeTests, Node)
   node_type node(-1);
   TestState state;
   ASSERT_GT(state.moves().size(), 2);
-  node.expand(state);
+  mcts::Arena<node_type> arena;
+  node.expand(state, arena);
   ASSERT_EQ(state.moves().size(), node.size());
   for (size_t i = 0; i < state.moves().size(); i++)
   {
@@ -103,8 +107,298 @@ TEST_F(MonteCarloTreeTests, Tree)
     paal::IterationCtrl ctrl(50);
     move = tree.search(ctrl);
     ASSERT_EQ(i, move);
+    size_t nodes = tree.nodes();
     tree.apply(move);
+    // the subtrees of the other moves are released
+    ASSERT_LT(tree.nodes(), nodes);
   }
 
   ASSERT_TRUE(tree.root_state().is_terminal());
 }
+
+/** TestState rolled back by undo, counts its copies */
+struct UndoTestState : TestState
+{
+  typedef Move Undo;
+
+  static size_t copies;
+  UndoTestState() {}
+  UndoTestState(const UndoTestState &other) : TestState(other) { ++copies; }
+
+  Undo apply(const Move& move)
+  {
+    TestState::apply(move);
+    return move;
+  }
+
+  void undo(const Undo& move)
+  {
+    moves_.push_back(move);
+    std::sort(moves_.begin(), moves_.end());
+  }
+};
+
+size_t UndoTestState::copies = 0;
+
+TEST_F(MonteCarloTreeTests, UndoState)
+{
+  using mcts::MonteCarloTree;
+
+  EXPECT_FALSE(mcts::is_undo_state<TestState>::value);
+  EXPECT_TRUE(mcts::is_undo_state<UndoTestState>::value);
+
+  UndoTestState state;
+  TestPolicy policy;
+  MonteCarloTree<UndoTestState, TestPolicy> tree(state, policy);
+  size_t copies = UndoTestState::copies;
+  for (size_t i = 0; i < 6; i++)
+  {
+    paal::IterationCtrl ctrl(50);
+    UndoTestState::Move move = tree.search(ctrl);
+    ASSERT_EQ(i, move);
+    // the root state is intact after the playouts
+    std::vector<UndoTestState::Move> left;
+    for (size_t m = i; m < 6; m++) left.push_back(m);
+    ASSERT_EQ(left, tree.root_state().moves_);
+    tree.apply(move);
+  }
+  EXPECT_EQ(copies, UndoTestState::copies);
+  ASSERT_TRUE(tree.root_state().is_terminal());
+}
+
+template<typename Node> void expect_no_pending(const Node &node)
+{
+  EXPECT_EQ(0u, node().pending);
+  EXPECT_EQ(0, node().pending_sum);
+  for (size_t i = 0; i < node.size(); i++) expect_no_pending(node[i]);
+}
+
+class MonteCarloTreeParallel :
+  public testing::TestWithParam<mcts::ParallelEnum> {};
+
+/** searches till the end of a tour with policies make(random) */
+template<typename Policy, typename Make>
+void parallel_search(mcts::ParallelEnum parallel, Make make,
+    double widening = 0)
+{
+  typedef tsp::TSPState<tsp::EuclidMatrix> State;
+  typedef mcts::MonteCarloTree<State, Policy> Tree;
+  enum { threads = 4, iterations = 400 };
+
+  std::vector<std::mt19937> randoms;
+  for (size_t t = 0; t < threads; t++) randoms.push_back(std::mt19937(t));
+  tsp::EuclidMatrix matrix;
+  matrix.generate(40, randoms[0]);
+  State state(matrix);
+  Tree tree(state, make(randoms[0]));
+  std::vector<Policy> policies;
+  for (size_t t = 1; t < threads; t++)
+    policies.push_back(make(randoms[t]));
+  tree.parallel(parallel, policies);
+  if (parallel != mcts::kTreeParallel) tree.transpositions(1 << 12);
+  if (parallel != mcts::kTreeParallel) tree.widening(widening);
+
+  while (!tree.root_state().is_terminal())
+  {
+    paal::IterationCtrl ctrl(iterations);
+    size_t visits = tree.root()().visits;
+    typename State::Move move = tree.search(ctrl);
+    EXPECT_EQ(iterations + 2, ctrl.passed_it);
+    if (parallel != mcts::kRootParallel)
+    {
+      // every playout passed through the root exactly once
+      EXPECT_EQ(visits + iterations + 1, tree.root()().visits);
+      expect_no_pending(tree.root());
+    }
+    tree.apply(move);
+  }
+  EXPECT_LT(0, tree.root_state().cost_);
+}
+
+TEST_P(MonteCarloTreeParallel, Search)
+{
+  typedef mcts::PolicyRandMean<std::mt19937> Policy;
+  parallel_search<Policy>(GetParam(),
+      [](std::mt19937 &random) { return Policy(random, 2); });
+}
+
+TEST_P(MonteCarloTreeParallel, SearchUCT)
+{
+  typedef mcts::PolicyUCT<std::mt19937> Policy;
+  parallel_search<Policy>(GetParam(),
+      [](std::mt19937 &random) { return Policy(random, 1., 2); }, 1.);
+}
+
+INSTANTIATE_TEST_CASE_P(MonteCarloTreeTests, MonteCarloTreeParallel,
+    testing::Values(mcts::kSequential, mcts::kRootParallel,
+      mcts::kTreeParallel));
+
+TEST_F(MonteCarloTreeTests, Transpositions)
+{
+  typedef mcts::PolicyRandMean<std::mt19937> Policy;
+  typedef tsp::TSPState<tsp::EuclidMatrix> State;
+  typedef mcts::MonteCarloTree<State, Policy> Tree;
+  std::mt19937 random(3);
+  tsp::EuclidMatrix matrix;
+  matrix.generate(7, random);
+  State state(matrix, 100, 0);
+  Tree tree(state, Policy(random, 1));
+  tree.transpositions(1 << 10);
+
+  paal::IterationCtrl ctrl(2000);
+  tree.search(ctrl);
+  // nodes after moves a, b, c and b, a, c share the payload
+  const Tree::Node &root = tree.root();
+  size_t shared = 0;
+  for (size_t i = 0; i < root.size(); i++)
+    for (size_t j = 0; j < root[i].size(); j++)
+      for (size_t k = 0; k < root[i][j].size(); k++)
+      {
+        const Tree::Node &abc = root[i][j][k];
+        for (size_t jj = 0; jj < root.size(); jj++)
+          for (size_t ii = 0; ii < root[jj].size(); ii++)
+          {
+            if (root[jj].move() != root[i][j].move() ||
+                root[jj][ii].move() != root[i].move()) continue;
+            for (size_t kk = 0; kk < root[jj][ii].size(); kk++)
+              if (root[jj][ii][kk].move() == abc.move())
+              {
+                EXPECT_TRUE(abc.shared_with(root[jj][ii][kk]));
+                shared++;
+              }
+          }
+      }
+  EXPECT_LT(0u, shared);
+
+  // statistics survive apply
+  size_t visits = root[0]().visits;
+  State::Move first = root[0].move();
+  tree.apply(first);
+  EXPECT_EQ(visits, tree.root()().visits);
+  while (!tree.root_state().is_terminal())
+  {
+    paal::IterationCtrl more(100);
+    tree.apply(tree.search(more));
+  }
+  EXPECT_LT(0, tree.root_state().cost_);
+}
+
+/** expands the nodes up to the given level only */
+template<typename Random> struct LevelPolicy : mcts::PolicyRandMean<Random>
+{
+  LevelPolicy(Random &random, size_t levels) :
+    mcts::PolicyRandMean<Random>(random, 1), levels_(levels) {}
+  template<typename Node> bool expand(const Node &, size_t level)
+  { return level < levels_; }
+  size_t levels_;
+};
+
+TEST_F(MonteCarloTreeTests, TranspositionsCostToGo)
+{
+  typedef LevelPolicy<std::mt19937> Policy;
+  typedef tsp::TSPState<tsp::EuclidMatrix> State;
+  typedef mcts::MonteCarloTree<State, Policy> Tree;
+  std::mt19937 random(11);
+  tsp::EuclidMatrix matrix;
+  matrix.generate(7, random);
+  // playouts from the leaves, after 3 of the 6 moves, are exhaustive
+  State state(matrix, 100, 8);
+  Tree tree(state, Policy(random, 3));
+  tree.transpositions(1 << 10);
+  paal::IterationCtrl ctrl(5000);
+  tree.search(ctrl);
+
+  // every estimate of a leaf is its path cost plus the cost to go, which
+  // equal states share, whatever the costs of their paths
+  const Tree::Node &root = tree.root();
+  size_t pairs = 0;
+  for (size_t i = 0; i < root.size(); i++)
+    for (size_t j = 0; j < root[i].size(); j++)
+      for (size_t k = 0; k < root[i][j].size(); k++)
+      {
+        const Tree::Node &leaf = root[i][j][k];
+        ASSERT_TRUE(leaf.is_leaf());
+        State path = state;
+        path.apply(root[i].move());
+        path.apply(root[i][j].move());
+        path.apply(leaf.move());
+        State best = path;
+        best.exhaustive_search_min();
+        if (leaf().visits)
+        {
+          EXPECT_NEAR(best.cost_, leaf().estimate, 1e-9);
+        }
+        for (size_t ii = 0; ii < root.size(); ii++)
+          for (size_t jj = 0; jj < root[ii].size(); jj++)
+          {
+            if (root[ii].move() != root[i][j].move() ||
+                root[ii][jj].move() != root[i].move()) continue;
+            State other = state;
+            other.apply(root[ii].move());
+            other.apply(root[ii][jj].move());
+            for (size_t kk = 0; kk < root[ii][jj].size(); kk++)
+              if (root[ii][jj][kk].shared_with(leaf) &&
+                  std::abs(other.cost(leaf.move()) - path.cost_) > 1e-6)
+                pairs++;
+          }
+      }
+  EXPECT_LT(0u, pairs);
+}
+
+/** children of node visible and in the nearest-first order of state */
+template<typename Node, typename State>
+void expect_widened(const Node &node, const State &state,
+    const mcts::Widening &widening)
+{
+  ASSERT_LE(node.size(), widening.children(node().visits));
+  std::vector<typename State::Move> nearest = state.moves(node.size());
+  for (size_t i = 0; i < node.size(); i++)
+    EXPECT_EQ(nearest[i], node[i].move());
+}
+
+TEST_F(MonteCarloTreeTests, Widening)
+{
+  typedef mcts::PolicyUCT<std::mt19937> Policy;
+  typedef tsp::TSPState<tsp::EuclidMatrix> State;
+  typedef mcts::MonteCarloTree<State, Policy> Tree;
+  std::mt19937 random(7);
+  tsp::EuclidMatrix matrix;
+  matrix.generate(200, random);
+  State state(matrix);
+  enum { iterations = 3000 };
+
+  Tree wide(state, Policy(random, 1., 2));
+  paal::IterationCtrl wide_ctrl(iterations);
+  wide.search(wide_ctrl);
+
+  Tree tree(state, Policy(random, 1., 2));
+  tree.transpositions(1 << 12);
+  tree.widening(2.);
+  mcts::Widening widening;
+  widening.coefficient = 2.;
+  EXPECT_EQ(1u, tree.root().size());
+  paal::IterationCtrl ctrl(iterations);
+  tree.search(ctrl);
+  const Tree::Node &root = tree.root();
+  EXPECT_EQ(iterations + 1, root().visits);
+  expect_widened(root, state, widening);
+  EXPECT_LT(root.size(), 2 * std::sqrt(iterations + 1.) + 1);
+  // statistics survive regrowing of the blocks
+  size_t visits = 0;
+  for (size_t i = 0; i < root.size(); i++)
+  {
+    visits += root[i]().visits;
+    State child = state;
+    child.apply(root[i].move());
+    expect_widened(root[i], child, widening);
+  }
+  EXPECT_EQ(iterations + 1, visits);
+  EXPECT_LT(tree.nodes() * 5, wide.nodes());
+
+  while (!tree.root_state().is_terminal())
+  {
+    paal::IterationCtrl step(100);
+    tree.apply(tree.search(step));
+  }
+  EXPECT_LT(0, tree.root_state().cost_);
+}
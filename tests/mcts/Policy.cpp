@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+
+#include <mcts/MonteCarloTree.h>
+#include <mcts/Policy.h>
+
+#include <random>
+#include <vector>
+
+/** the part of a node policies use */
+template<typename Policy> struct PayloadNode
+{
+  typename Policy::Payload payload;
+  typename mcts::policy_cache<Policy>::type cache_;
+  std::vector<PayloadNode> children;
+
+  explicit PayloadNode(size_t size = 0) : children(size) {}
+  typename Policy::Payload & operator()() { return payload; }
+  const typename Policy::Payload & operator()() const { return payload; }
+  typename mcts::policy_cache<Policy>::type & cache() { return cache_; }
+  const typename mcts::policy_cache<Policy>::type & cache() const
+  { return cache_; }
+  PayloadNode & operator[](size_t i) { return children[i]; }
+  const PayloadNode & operator[](size_t i) const { return children[i]; }
+  size_t size() const { return children.size(); }
+};
+
+typedef std::mt19937 Random;
+
+TEST(mcts_Policy, virtual_loss)
+{
+  Random random;
+  typedef mcts::PolicyEpsMean<Random> Policy;
+  Policy policy(random);
+  PayloadNode<Policy> node(2);
+  PayloadNode<Policy> &a = node[0], &b = node[1];
+  policy.update(a, -1, 10);
+  policy.update(b, -1, 11);
+  EXPECT_TRUE(a() < b());
+  policy.add_virtual_loss(node, 0, 20);
+  EXPECT_TRUE(b() < a());
+  policy.remove_virtual_loss(node, 0, 20);
+  EXPECT_TRUE(a() < b());
+  EXPECT_EQ(0u, a().pending);
+  EXPECT_EQ(0, a().pending_sum);
+}
+
+TEST(mcts_Policy, merge_mean)
+{
+  Random random;
+  typedef mcts::PolicyRandMean<Random> Policy;
+  Policy policy(random);
+  PayloadNode<Policy> a, b, all;
+  std::vector<double> estimates = {3, 5, 8, 1, 4};
+  for (size_t i = 0; i < estimates.size(); i++)
+  {
+    policy.update(i < 2 ? a : b, -1, estimates[i]);
+    policy.update(all, -1, estimates[i]);
+  }
+  Policy::Payload merged = a(), empty;
+  policy.merge(merged, b());
+  EXPECT_EQ(all().visits, merged.visits);
+  EXPECT_DOUBLE_EQ(all().estimate, merged.estimate);
+  policy.merge(merged, empty);
+  EXPECT_DOUBLE_EQ(all().estimate, merged.estimate);
+  policy.merge(empty, a());
+  EXPECT_DOUBLE_EQ(a().estimate, empty.estimate);
+}
+
+TEST(mcts_Policy, merge_mu_sigma)
+{
+  Random random;
+  typedef mcts::PolicyMuSigma<Random> Policy;
+  Policy policy(random, 2.);
+  PayloadNode<Policy> a, b, all;
+  std::vector<double> estimates = {3, 5, 8, 1, 4, 7, 7};
+  for (size_t i = 0; i < estimates.size(); i++)
+  {
+    policy.update(i < 3 ? a : b, -1, estimates[i]);
+    policy.update(all, -1, estimates[i]);
+  }
+  policy.merge(a(), b());
+  EXPECT_EQ(all().visits, a().visits);
+  EXPECT_NEAR(all().mean, a().mean, 1e-9);
+  EXPECT_NEAR(all().interm, a().interm, 1e-9);
+  EXPECT_NEAR(all().factor, a().factor, 1e-9);
+}
+
+TEST(mcts_Policy, merge_eps_best)
+{
+  Random random;
+  typedef mcts::PolicyEpsBest<Random> Policy;
+  Policy policy(random);
+  PayloadNode<Policy> a, b;
+  policy.update(a, 0, 5);
+  policy.update(b, 3, 4);
+  policy.update(b, 1, 6);
+  policy.merge(a(), b());
+  EXPECT_EQ(3u, a().visits);
+  EXPECT_EQ(4, a().estimate);
+  EXPECT_EQ(3u, a().best_child);
+}
+
+typedef mcts::PolicyUCT<Random> UCT;
+
+/** playout through node[chosen] returning estimate */
+void visit(UCT &policy, PayloadNode<UCT> &node, size_t chosen,
+    double estimate)
+{
+  policy.update(node[chosen], -1, estimate);
+  policy.update(node, chosen, estimate);
+}
+
+TEST(mcts_Policy, uct_unvisited_first)
+{
+  Random random;
+  UCT policy(random);
+  PayloadNode<UCT> node(5);
+  for (size_t i = 0; i < node.size(); i++)
+  {
+    EXPECT_EQ(i, policy.choose(node));
+    visit(policy, node, i, i);
+  }
+  EXPECT_EQ(0u, policy.choose(node));
+}
+
+TEST(mcts_Policy, uct_chooses_lowest_bound)
+{
+  Random random;
+  UCT policy(random, 2.);
+  enum { children = 37 };
+  PayloadNode<UCT> node(children);
+  // estimates in [0, 1], so the range R seen by the node stays 1
+  policy.update(node, -1, 0);
+  policy.update(node, -1, 1);
+  std::uniform_real_distribution<double> noise(0, .5);
+  for (size_t it = 0; it < 3000; it++)
+  {
+    size_t chosen = policy.choose(node);
+    double log = node.cache().built_log;
+    size_t best = 0;
+    for (size_t i = 1; i < node.size(); i++)
+      if (policy.bound(node, i, log) < policy.bound(node, best, log))
+        best = i;
+    ASSERT_DOUBLE_EQ(policy.bound(node, best, log),
+        policy.bound(node, chosen, log));
+    visit(policy, node, chosen, noise(random) + chosen % 2 * .5);
+  }
+  // even children are better and visited more
+  size_t even = 0;
+  for (size_t i = 0; i < node.size(); i += 2) even += node[i]().visits;
+  EXPECT_LT(node().visits * 3 / 4, even);
+  size_t best = 0;
+  for (size_t i = 1; i < node.size(); i++)
+    if (node[i]() < node[best]()) best = i;
+  EXPECT_EQ(0u, best % 2);
+}
+
+TEST(mcts_Policy, uct_virtual_loss)
+{
+  Random random;
+  UCT policy(random);
+  PayloadNode<UCT> node(3);
+  for (size_t i = 0; i < 30; i++) visit(policy, node, i % 3, i % 3);
+  size_t chosen = policy.choose(node);
+  EXPECT_EQ(0u, chosen);
+  policy.add_virtual_loss(node, chosen, 100);
+  EXPECT_NE(chosen, policy.choose(node));
+  policy.remove_virtual_loss(node, chosen, 100);
+  EXPECT_EQ(chosen, policy.choose(node));
+  EXPECT_EQ(0u, node[chosen]().pending);
+}
+
+TEST(mcts_Policy, merge_uct)
+{
+  Random random;
+  UCT policy(random);
+  PayloadNode<UCT> a, b, all;
+  std::vector<double> estimates = {3, 5, 8, 1, 4, 7, 7};
+  for (size_t i = 0; i < estimates.size(); i++)
+  {
+    policy.update(i < 3 ? a : b, -1, estimates[i]);
+    policy.update(all, -1, estimates[i]);
+  }
+  policy.merge(a(), b());
+  EXPECT_EQ(all().visits, a().visits);
+  EXPECT_NEAR(all().mean, a().mean, 1e-9);
+  EXPECT_NEAR(all().interm, a().interm, 1e-9);
+  EXPECT_EQ(1, a().min);
+  EXPECT_EQ(8, a().max);
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <set>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "mcts/TranspositionTable.h"
+
+typedef mcts::TranspositionTable<int> Table;
+
+TEST(mcts_TranspositionTable, find_or_insert)
+{
+  Table table(100);
+  EXPECT_EQ(128u, table.size());
+  bool inserted;
+  Table::Entry *a = table.find_or_insert(mcts::mix64(1), inserted);
+  ASSERT_TRUE(a);
+  EXPECT_TRUE(inserted);
+  a->payload = 7;
+  EXPECT_EQ(a, table.find_or_insert(mcts::mix64(1), inserted));
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(7, a->payload);
+  Table::Entry *b = table.find_or_insert(mcts::mix64(2), inserted);
+  EXPECT_TRUE(inserted);
+  EXPECT_NE(a, b);
+  // hash 0 is valid
+  EXPECT_TRUE(table.find_or_insert(0, inserted));
+  EXPECT_TRUE(inserted);
+  EXPECT_EQ(3u, table.used());
+
+  table.clear();
+  EXPECT_EQ(0u, table.used());
+  EXPECT_EQ(a, table.find_or_insert(mcts::mix64(1), inserted));
+  EXPECT_TRUE(inserted);
+  EXPECT_EQ(0, a->payload);
+}
+
+TEST(mcts_TranspositionTable, full)
+{
+  Table table(16);
+  bool inserted;
+  // hashes probing the same entries
+  for (uint64_t i = 0; i < Table::kProbes; i++)
+    EXPECT_TRUE(table.find_or_insert(1 + 16 * i, inserted));
+  EXPECT_FALSE(table.find_or_insert(1 + 16 * Table::kProbes, inserted));
+  EXPECT_TRUE(table.find_or_insert(1, inserted));
+  EXPECT_FALSE(inserted);
+}
+
+TEST(mcts_TranspositionTable, concurrent)
+{
+  enum { threads = 4, keys = 1000 };
+  Table table(4 * keys);
+  std::vector<std::vector<Table::Entry *> > found(threads,
+      std::vector<Table::Entry *>(keys));
+  std::atomic<int> inserts(0);
+  std::vector<std::thread> pool;
+  for (size_t t = 0; t < threads; t++)
+    pool.push_back(std::thread([&, t]()
+          {
+            for (size_t k = 0; k < keys; k++)
+            {
+              bool inserted;
+              found[t][k] = table.find_or_insert(mcts::mix64(k), inserted);
+              inserts += inserted;
+            }
+          }));
+  for (auto &thread : pool) thread.join();
+  EXPECT_EQ(keys, table.used());
+  EXPECT_EQ(keys, inserts);
+  std::set<Table::Entry *> entries;
+  for (size_t k = 0; k < keys; k++)
+  {
+    ASSERT_TRUE(found[0][k]);
+    for (size_t t = 1; t < threads; t++) EXPECT_EQ(found[0][k], found[t][k]);
+    entries.insert(found[0][k]);
+  }
+  EXPECT_EQ(keys, entries.size());
+}
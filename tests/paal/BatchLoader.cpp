@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <memory>
+#include <stdexcept>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "paal/BatchLoader.h"
+
+typedef paal::BatchLoader<std::vector<int> > Loader;
+
+inline Loader::Pointer make_instance(size_t i)
+{
+  return Loader::Pointer(new std::vector<int>(i + 1, i));
+}
+
+TEST(paal_BatchLoader, in_order)
+{
+  enum { n = 50 };
+  Loader loader(n, [](size_t i)
+      {
+        // later instances are loaded faster
+        std::this_thread::sleep_for(std::chrono::microseconds(50 - i));
+        return make_instance(i);
+      }, 4, 3);
+  EXPECT_EQ(n, loader.size());
+  for (size_t i = 0; i < n; ++i)
+  {
+    EXPECT_EQ(i, loader.position());
+    Loader::Pointer instance = loader.next();
+    ASSERT_TRUE(instance.get());
+    EXPECT_EQ(*make_instance(i), *instance);
+  }
+  EXPECT_FALSE(loader.next().get());
+  EXPECT_FALSE(loader.next().get());
+}
+
+TEST(paal_BatchLoader, bounded_window)
+{
+  enum { n = 20, window = 3 };
+  std::atomic<size_t> loaded(0);
+  Loader loader(n, [&](size_t i)
+      {
+        ++loaded;
+        return make_instance(i);
+      }, 4, window);
+  for (size_t i = 0; i < n; ++i)
+  {
+    // wait for the window to fill up
+    while (loaded < std::min<size_t>(n, i + window))
+      std::this_thread::yield();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    EXPECT_EQ(std::min<size_t>(n, i + window), loaded);
+    EXPECT_TRUE(loader.next().get());
+  }
+  EXPECT_EQ(n, loaded);
+}
+
+TEST(paal_BatchLoader, exception)
+{
+  Loader loader(5, [](size_t i)
+      {
+        if (i == 2) throw std::runtime_error("cannot load");
+        return make_instance(i);
+      }, 2);
+  EXPECT_TRUE(loader.next().get());
+  EXPECT_TRUE(loader.next().get());
+  EXPECT_THROW(loader.next(), std::runtime_error);
+  EXPECT_EQ(*make_instance(3), *loader.next());
+  EXPECT_EQ(*make_instance(4), *loader.next());
+  EXPECT_FALSE(loader.next().get());
+}
+
+TEST(paal_BatchLoader, early_destruction)
+{
+  std::atomic<size_t> loaded(0);
+  {
+    Loader loader(1000, [&](size_t i)
+        {
+          ++loaded;
+          return make_instance(i);
+        }, 2, 4);
+    EXPECT_TRUE(loader.next().get());
+  }
+  EXPECT_LE(loaded, 5u);
+}
+
+TEST(paal_BatchLoader, empty)
+{
+  Loader loader(0, make_instance);
+  EXPECT_EQ(0u, loader.size());
+  EXPECT_FALSE(loader.next().get());
+}
@@ -44,3 +44,24 @@ TEST(paal_ProgressCtrl, TimeAutoCtrl_sanity)
     prev = prog;
   }
 }
+
+struct ConvergingWalker
+{
+  size_t steps;
+  bool converged() const
+  {
+    return !steps;
+  }
+};
+
+TEST(paal_ProgressCtrl, ConvergenceCtrl)
+{
+  enum { it = 10, fitness = 123 };
+  ConvergingWalker walker = { 3 };
+  paal::IterationCtrl iteration_ctrl(it);
+  paal::ConvergenceCtrl<ConvergingWalker, paal::IterationCtrl>
+    progress_ctrl(walker, iteration_ctrl);
+  for (; walker.steps; --walker.steps)
+    ASSERT_LT(progress_ctrl.progress(fitness), 1);
+  ASSERT_GE(progress_ctrl.progress(fitness), 1);
+}
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "paal/parallel_search.h"
+#include "paal/ProgressCtrl.h"
+#include "paal/StepCtrl.h"
+
+/**
+ * every step decreases fitness by a walker specific value, or increases it
+ * once turn steps are made
+ */
+struct DecWalker
+{
+  DecWalker(double _fitness, double _dec) :
+    fitness(_fitness), dec(_dec), steps_made(0), turn(-1) {}
+  double fitness, dec;
+  size_t steps_made, turn;
+
+  template<typename Random> void prepare_step(double progress, Random &random)
+  {
+    EXPECT_GE(progress, 0);
+    EXPECT_LT(progress, 1);
+  }
+
+  void make_step()
+  {
+    fitness = next_fitness();
+    steps_made++;
+  }
+
+  double current_fitness()
+  {
+    return fitness;
+  }
+
+  double next_fitness()
+  {
+    return steps_made < turn ? fitness - dec : fitness + dec;
+  }
+};
+
+/** @return number of steps made by the walker */
+size_t steps_made(const DecWalker &w)
+{
+  return w.steps_made;
+}
+
+/** @brief [implements StepCtrl] makes every step */
+struct AlwaysStep
+{
+  template<typename Random> bool step_decision(double, double, double,
+      Random &)
+  {
+    return true;
+  }
+};
+
+TEST(paal_parallel_search, best_walker)
+{
+  enum { n = 7, it = 100 };
+  std::vector<DecWalker> walkers;
+  std::vector<std::mt19937> randoms;
+  std::vector<paal::IterationCtrl> progress_ctrls;
+  std::vector<paal::HillClimb> step_ctrls(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    walkers.push_back(DecWalker(1000, i == 3 ? 2 : 1));
+    randoms.push_back(std::mt19937(i));
+    progress_ctrls.push_back(paal::IterationCtrl(it));
+  }
+  paal::BestSlot<size_t> best;
+  size_t bi = paal::parallel_search(walkers, randoms, progress_ctrls,
+      step_ctrls, best, steps_made, 3);
+  EXPECT_EQ(3, bi);
+  EXPECT_EQ(3, best.walker());
+  EXPECT_EQ(1000 - 2 * it, best.fitness());
+  EXPECT_EQ(it, best.solution());
+  for (auto &w : walkers) EXPECT_EQ(it, w.steps_made);
+  for (auto &p : progress_ctrls) EXPECT_EQ(it + 1, p.passed_it);
+}
+
+TEST(paal_parallel_search, best_ever)
+{
+  // walkers turn back halfway, so their final fitness is worse than the best
+  // one reached, as under Annealing
+  enum { n = 5, it = 40 };
+  std::vector<DecWalker> walkers;
+  std::vector<std::mt19937> randoms;
+  std::vector<paal::IterationCtrl> progress_ctrls;
+  std::vector<AlwaysStep> step_ctrls(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    walkers.push_back(DecWalker(100, 1 + i));
+    walkers.back().turn = it / 2;
+    randoms.push_back(std::mt19937(i));
+    progress_ctrls.push_back(paal::IterationCtrl(it));
+  }
+  paal::BestSlot<size_t> best;
+  size_t bi = paal::parallel_search(walkers, randoms, progress_ctrls,
+      step_ctrls, best, steps_made, 2);
+  EXPECT_EQ(n - 1, bi);
+  EXPECT_EQ(100 - int(n * it / 2), best.fitness());
+  EXPECT_EQ(it / 2, best.solution());
+  for (auto &w : walkers) EXPECT_LT(best.fitness(), w.current_fitness());
+}
+
+TEST(paal_parallel_search, BestSlot)
+{
+  paal::BestSlot<int> best;
+  EXPECT_TRUE(best.offer(10, 1, [] { return 100; }));
+  // the solution is taken only by the offer which becomes the best
+  EXPECT_FALSE(best.offer(12, 2, []() -> int
+  {
+    ADD_FAILURE();
+    return 120;
+  }));
+  EXPECT_TRUE(best.offer(7, 3, [] { return 70; }));
+  EXPECT_FALSE(best.offer(7, 4, [] { return 71; }));
+  EXPECT_EQ(7, best.fitness());
+  EXPECT_EQ(3, best.walker());
+  EXPECT_EQ(70, best.solution());
+}
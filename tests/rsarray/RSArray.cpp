@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 
+#include <random>
 #include <vector>
 
 #include "rsarray/RSArray.h"
@@ -91,3 +92,21 @@ TEST(RSArray, random)
   }
 }
 
+
+TEST(RSArray, position)
+{
+  std::mt19937 random(9127);
+  size_t n = 100;
+  RSA c1;
+  identity(c1, n);
+  const RSA &c = c1;
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    size_t l = random() % n, r = random() % (n - l + 1) + l;
+    c1.reverse(l, r);
+    for (size_t j = 0; j < n; ++j) ASSERT_EQ(j, c1.position(c[j]));
+  }
+  std::swap(c1[0], c1[1]);
+  EXPECT_EQ(0, c1.position(c[0]));
+  EXPECT_EQ(1, c1.position(c[1]));
+}
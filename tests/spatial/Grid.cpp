@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "spatial/Grid.h"
+#include "tsp/EuclidMatrix.h"
+
+typedef spatial::Grid::Neighbor Neighbor;
+
+/** k nearest of the points not removed, by brute force */
+inline std::vector<Neighbor> brute_knn(const std::vector<tsp::Point> &pos,
+    const std::vector<bool> &removed, const tsp::Point &q, size_t k,
+    uint32_t skip)
+{
+  std::vector<Neighbor> all;
+  for (size_t i = 0; i < pos.size(); ++i)
+    if (!removed[i] && i != skip)
+      all.push_back(Neighbor((q - pos[i]).sqr(), i));
+  std::sort(all.begin(), all.end());
+  all.resize(std::min(k, all.size()));
+  return all;
+}
+
+TEST(spatial_Grid, knn)
+{
+  std::mt19937 random(7123);
+  for (size_t n : { 0, 1, 2, 10, 500 })
+  {
+    tsp::EuclidMatrix m;
+    m.generate(n, random);
+    spatial::Grid grid(m.pos);
+    std::vector<bool> removed(n, false);
+    std::vector<Neighbor> found;
+    for (size_t i = 0; i < n; ++i)
+      for (size_t k : { 1, 3, 8 })
+      {
+        grid.knn(m.pos[i], k, found, i);
+        ASSERT_EQ(brute_knn(m.pos, removed, m.pos[i], k, i), found);
+      }
+    // queries outside of the bounding box
+    tsp::Point q(2, -1);
+    grid.knn(q, 4, found);
+    EXPECT_EQ(brute_knn(m.pos, removed, q, 4, n), found);
+  }
+}
+
+TEST(spatial_Grid, remove)
+{
+  std::mt19937 random(991);
+  enum { n = 300 };
+  tsp::EuclidMatrix m;
+  m.generate(n, random);
+  spatial::Grid grid(m.pos);
+  std::vector<bool> removed(n, false);
+  std::vector<Neighbor> found;
+  for (size_t left = n; left; --left)
+  {
+    EXPECT_EQ(left, grid.size());
+    tsp::Point q(double(random()) / random.max(),
+        double(random()) / random.max());
+    grid.knn(q, 5, found);
+    ASSERT_EQ(brute_knn(m.pos, removed, q, 5, n), found);
+    uint32_t v = grid.nearest(q);
+    ASSERT_EQ(found[0].second, v);
+    EXPECT_TRUE(grid.contains(v));
+    grid.remove(v);
+    removed[v] = true;
+    EXPECT_FALSE(grid.contains(v));
+  }
+  EXPECT_EQ(uint32_t(spatial::Grid::kNone), grid.nearest(tsp::Point(0, 0)));
+}
+
+TEST(spatial_Grid, radius)
+{
+  std::mt19937 random(3331);
+  tsp::EuclidMatrix m;
+  m.generate(400, random);
+  spatial::Grid grid(m.pos);
+  std::vector<uint32_t> found;
+  for (double r : { 0., 0.01, 0.1, 0.5, 2. })
+  {
+    tsp::Point q = m.pos[17];
+    grid.radius(q, r, found);
+    std::sort(found.begin(), found.end());
+    std::vector<uint32_t> expected;
+    for (size_t i = 0; i < m.pos.size(); ++i)
+      if ((q - m.pos[i]).sqr() <= r * r) expected.push_back(i);
+    EXPECT_EQ(expected, found) << r;
+  }
+}
+
+TEST(spatial_Grid, duplicates)
+{
+  std::vector<tsp::Point> pos(50, tsp::Point(1, 1));
+  spatial::Grid grid(pos);
+  std::vector<Neighbor> found;
+  grid.knn(pos[0], 3, found, 0);
+  ASSERT_EQ(3u, found.size());
+  EXPECT_EQ(Neighbor(0, 1), found[0]);
+  EXPECT_EQ(Neighbor(0, 3), found[2]);
+}
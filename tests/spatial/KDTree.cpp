@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "spatial/KDTree.h"
+#include "tsp/EuclidMatrix.h"
+
+typedef spatial::KDTree::Neighbor Neighbor;
+
+/** k nearest of the points not removed, by brute force */
+inline std::vector<Neighbor> brute_knn(const std::vector<tsp::Point> &pos,
+    const std::vector<bool> &removed, const tsp::Point &q, size_t k,
+    uint32_t skip)
+{
+  std::vector<Neighbor> all;
+  for (size_t i = 0; i < pos.size(); ++i)
+    if (!removed[i] && i != skip)
+      all.push_back(Neighbor((q - pos[i]).sqr(), i));
+  std::sort(all.begin(), all.end());
+  all.resize(std::min(k, all.size()));
+  return all;
+}
+
+TEST(spatial_KDTree, knn)
+{
+  std::mt19937 random(7123);
+  for (size_t n : { 0, 1, 2, 10, 500 })
+  {
+    tsp::EuclidMatrix m;
+    m.generate(n, random);
+    spatial::KDTree tree(m.pos);
+    std::vector<bool> removed(n, false);
+    std::vector<Neighbor> found;
+    for (size_t i = 0; i < n; ++i)
+      for (size_t k : { 1, 3, 8 })
+      {
+        tree.knn(m.pos[i], k, found, i);
+        ASSERT_EQ(brute_knn(m.pos, removed, m.pos[i], k, i), found);
+      }
+    // queries outside of the bounding box
+    tsp::Point q(2, -1);
+    tree.knn(q, 4, found);
+    EXPECT_EQ(brute_knn(m.pos, removed, q, 4, n), found);
+  }
+}
+
+TEST(spatial_KDTree, remove)
+{
+  std::mt19937 random(991);
+  enum { n = 300 };
+  tsp::EuclidMatrix m;
+  m.generate(n, random);
+  spatial::KDTree tree(m.pos);
+  std::vector<bool> removed(n, false);
+  std::vector<Neighbor> found;
+  for (size_t left = n; left; --left)
+  {
+    EXPECT_EQ(left, tree.size());
+    tsp::Point q(double(random()) / random.max(),
+        double(random()) / random.max());
+    tree.knn(q, 5, found);
+    ASSERT_EQ(brute_knn(m.pos, removed, q, 5, n), found);
+    uint32_t v = tree.nearest(q);
+    ASSERT_EQ(found[0].second, v);
+    EXPECT_TRUE(tree.contains(v));
+    tree.remove(v);
+    removed[v] = true;
+    EXPECT_FALSE(tree.contains(v));
+  }
+  EXPECT_EQ(uint32_t(spatial::KDTree::kNone), tree.nearest(tsp::Point(0, 0)));
+}
+
+TEST(spatial_KDTree, radius)
+{
+  std::mt19937 random(3331);
+  tsp::EuclidMatrix m;
+  m.generate(400, random);
+  spatial::KDTree tree(m.pos);
+  std::vector<uint32_t> found;
+  for (double r : { 0., 0.01, 0.1, 0.5, 2. })
+  {
+    tsp::Point q = m.pos[17];
+    tree.radius(q, r, found);
+    std::sort(found.begin(), found.end());
+    std::vector<uint32_t> expected;
+    for (size_t i = 0; i < m.pos.size(); ++i)
+      if ((q - m.pos[i]).sqr() <= r * r) expected.push_back(i);
+    EXPECT_EQ(expected, found) << r;
+  }
+}
+
+TEST(spatial_KDTree, duplicates)
+{
+  std::vector<tsp::Point> pos(50, tsp::Point(1, 1));
+  spatial::KDTree tree(pos);
+  std::vector<Neighbor> found;
+  tree.knn(pos[0], 3, found, 0);
+  ASSERT_EQ(3u, found.size());
+  EXPECT_EQ(Neighbor(0, 1), found[0]);
+  EXPECT_EQ(Neighbor(0, 3), found[2]);
+}
+
+TEST(spatial_KDTree, clustered)
+{
+  // tight clusters far apart, the removal order of a nearest neighbour tour
+  std::mt19937 random(62);
+  std::normal_distribution<double> noise(0, 1e-4);
+  std::vector<tsp::Point> pos;
+  for (size_t c = 0; c < 5; ++c)
+    for (size_t i = 0; i < 200; ++i)
+      pos.push_back(tsp::Point(c + noise(random), c * c + noise(random)));
+  spatial::KDTree tree(pos);
+  std::vector<bool> removed(pos.size(), false);
+  uint32_t v = 0;
+  for (size_t i = 1; i < pos.size(); ++i)
+  {
+    tree.remove(v);
+    removed[v] = true;
+    uint32_t u = tree.nearest(pos[v]);
+    ASSERT_EQ(brute_knn(pos, removed, pos[v], 1, v)[0].second, u);
+    v = u;
+  }
+}
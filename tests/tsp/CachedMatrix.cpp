@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+#include <boost/numeric/ublas/matrix.hpp>
+
+#include "tsp/CachedMatrix.h"
+#include "tsp/EuclidMatrix.h"
+#include "tsp/TwoOptWalker.h"
+#include "tsp/util.h"
+
+template<typename Matrix>
+void check_equal(const Matrix &m, const tsp::CachedMatrix<Matrix> &cached,
+    double eps)
+{
+  ASSERT_EQ(m.size1(), cached.size1());
+  ASSERT_EQ(m.size2(), cached.size2());
+  for (size_t i = 0; i < m.size1(); ++i)
+    for (size_t j = 0; j < m.size1(); ++j)
+      ASSERT_NEAR(m(i, j), cached(i, j), eps);
+}
+
+TEST(tsp_CachedMatrix, dense)
+{
+  std::mt19937 random(1827);
+  tsp::EuclidMatrix m;
+  m.generate(100, random);
+  tsp::CachedMatrix<tsp::EuclidMatrix> cached(m);
+  EXPECT_TRUE(cached.dense());
+  check_equal(m, cached, 1e-6);
+  EXPECT_EQ(&m.pos, tsp::matrix_points(cached));
+}
+
+TEST(tsp_CachedMatrix, sparse)
+{
+  std::mt19937 random(1827);
+  tsp::EuclidMatrix m;
+  m.generate(100, random);
+  tsp::CachedMatrix<tsp::EuclidMatrix> cached(m, 50, 5);
+  EXPECT_FALSE(cached.dense());
+  check_equal(m, cached, 1e-6);
+}
+
+TEST(tsp_CachedMatrix, integral)
+{
+  typedef boost::numeric::ublas::matrix<int> Matrix;
+  enum { n = 30 };
+  std::mt19937 random(1827);
+  Matrix m(n, n);
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = 0; j <= i; ++j) m(i, j) = m(j, i) = i == j ? 0 : random();
+  tsp::CachedMatrix<Matrix> cached(m), sparse(m, 10, 4);
+  static_assert(std::is_same<int32_t,
+      tsp::CachedMatrix<Matrix>::value_type>::value, "int32_t storage");
+  EXPECT_EQ(nullptr, tsp::matrix_points(cached));
+  check_equal(m, cached, 0);
+  check_equal(m, sparse, 0);
+}
+
+TEST(tsp_CachedMatrix, walker)
+{
+  typedef tsp::CachedMatrix<tsp::EuclidMatrix> Matrix;
+  std::mt19937 random(1827);
+  tsp::EuclidMatrix m;
+  m.generate(100, random);
+  Matrix cached(m);
+  std::vector<size_t> c;
+  tsp::cycle_shuffle(c, m.size1(), random);
+  tsp::TwoOptWalker<Matrix> walker(cached, c);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    walker.prepare_step(0, random);
+    if (walker.next_fitness() < walker.current_fitness()) walker.make_step();
+  }
+  EXPECT_NEAR(tsp::fitness(m, walker.cycle), walker.current_fitness(), 1e-3);
+}
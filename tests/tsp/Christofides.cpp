@@ -2,10 +2,17 @@
 
 #include "tsp/Christofides.h"
 
+#include <boost/graph/connected_components.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "tsp/EuclidMatrix.h"
 #include "tsp/TSPLIB.h"
 #include "tsp/util.h"
 
@@ -47,3 +54,191 @@ TEST(ChristofidesAlg, GeoTest) {
       EXPECT_GE(1.1 * tsp::fitness(mtx, cycle), tsp::fitness(mtx, cycle_geo));
     }
 }
+
+/** @returns total weight of edges of the graph */
+template<typename Matrix, typename Graph>
+double tree_weight(const Matrix &matrix, const Graph &tree) {
+  double weight = 0;
+  typename boost::graph_traits<Graph>::edge_iterator e, end;
+  for (boost::tie(e, end) = boost::edges(tree); e != end; ++e) {
+    weight += matrix(boost::source(*e, tree), boost::target(*e, tree));
+  }
+  return weight;
+}
+
+TEST(ChristofidesMST, PrimKruskal) {
+  typedef boost::adjacency_list<boost::vecS, boost::vecS,
+      boost::undirectedS> AdjList;
+  std::mt19937 random(81723);
+  for (size_t n : {1, 2, 3, 10, 300}) {
+    tsp::EuclidMatrix mtx;
+    mtx.generate(n, random);
+    AdjList prim(n), kruskal(n), sparse(n);
+    tsp::mst_prim(mtx, prim, n);
+    tsp::mst_kruskal_neighbors(mtx, kruskal, mtx.pos);
+    // spanning, but not necessarily minimum
+    tsp::mst_kruskal_neighbors(mtx, sparse, mtx.pos, 2);
+    EXPECT_EQ(n - 1, boost::num_edges(prim));
+    EXPECT_EQ(n - 1, boost::num_edges(kruskal));
+    EXPECT_EQ(n - 1, boost::num_edges(sparse));
+    std::vector<int> component(n);
+    EXPECT_EQ(1, boost::connected_components(prim, &component[0]));
+    EXPECT_EQ(1, boost::connected_components(sparse, &component[0]));
+    EXPECT_NEAR(tree_weight(mtx, prim), tree_weight(mtx, kruskal), 1e-9);
+    EXPECT_LE(tree_weight(mtx, prim), tree_weight(mtx, sparse) + 1e-9);
+  }
+}
+
+TEST(ChristofidesMST, Clusters) {
+  typedef boost::adjacency_list<boost::vecS, boost::vecS,
+      boost::undirectedS> AdjList;
+  // distant clusters are not connected by the graph of few neighbours
+  tsp::EuclidMatrix mtx;
+  for (int c = 0; c < 4; ++c) {
+    for (int i = 0; i < 20; ++i) {
+      mtx.pos.push_back(tsp::Point(1000 * c + i % 5, 1000 * c + i / 5));
+    }
+  }
+  size_t n = mtx.size1();
+  AdjList prim(n), kruskal(n);
+  tsp::mst_prim(mtx, prim, n);
+  tsp::mst_kruskal_neighbors(mtx, kruskal, mtx.pos, 3);
+  EXPECT_EQ(n - 1, boost::num_edges(kruskal));
+  EXPECT_NEAR(tree_weight(mtx, prim), tree_weight(mtx, kruskal), 1e-9);
+}
+
+TEST(ChristofidesEuler, Circuit) {
+  // two triangles sharing vertex 0 and a doubled edge 3-4
+  std::vector<std::pair<uint32_t, uint32_t> > edges = {
+    {0, 1}, {1, 2}, {2, 0}, {0, 3}, {3, 4}, {4, 3}, {3, 0}
+  };
+  tsp::EulerGraph graph;
+  graph.assign(5, edges);
+  EXPECT_EQ(5, graph.num_vertices());
+  EXPECT_EQ(edges.size(), graph.num_edges());
+  std::vector<uint32_t> circuit;
+  tsp::find_eulerian_circuit(graph, 0, circuit);
+  ASSERT_EQ(edges.size() + 1, circuit.size());
+  EXPECT_EQ(circuit.front(), circuit.back());
+  // every edge is traversed exactly once
+  std::multiset<std::pair<uint32_t, uint32_t> > expected, traversed;
+  for (auto e : edges) {
+    expected.insert(std::minmax(e.first, e.second));
+  }
+  for (size_t i = 0; i + 1 < circuit.size(); ++i) {
+    traversed.insert(std::minmax(circuit[i], circuit[i + 1]));
+  }
+  EXPECT_EQ(expected, traversed);
+
+  std::vector<int> cycle(5);
+  tsp::find_hamiltonian_cycle(circuit, &cycle, 5);
+  std::sort(cycle.begin(), cycle.end());
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 3, 4}), cycle);
+}
+
+TEST(ChristofidesEuler, Permutation) {
+  std::mt19937 random(9123);
+  for (size_t n : {1, 2, 5, 200}) {
+    tsp::EuclidMatrix mtx;
+    mtx.generate(n, random);
+    std::vector<int> cycle(n);
+    tsp::christofides(mtx, cycle, n);
+    std::sort(cycle.begin(), cycle.end());
+    for (size_t i = 0; i < n; ++i) {
+      EXPECT_EQ(i, cycle[i]);
+    }
+  }
+}
+
+TEST(ChristofidesMatching, SparseEdges) {
+  std::mt19937 random(1231);
+  tsp::EuclidMatrix mtx;
+  mtx.generate(100, random);
+  std::vector<int> ids;
+  for (int i = 0; i < 100; i += 3) {
+    ids.push_back(i);
+  }
+  std::vector<std::pair<int, int> > edges, scanned;
+  tsp::sparse_matching_edges(mtx, ids, 3, edges);
+  boost::numeric::ublas::matrix<double> explicit_mtx(100, 100);
+  for (size_t i = 0; i < 100; ++i) {
+    for (size_t j = 0; j < 100; ++j) {
+      explicit_mtx(i, j) = mtx(i, j);
+    }
+  }
+  tsp::sparse_matching_edges(explicit_mtx, ids, 3, scanned);
+  EXPECT_EQ(edges, scanned);
+  std::set<std::pair<int, int> > edge_set(edges.begin(), edges.end());
+  EXPECT_EQ(edges.size(), edge_set.size());
+  for (size_t i = 0; i + 1 < ids.size(); i += 2) {
+    EXPECT_TRUE(edge_set.count(std::make_pair(i, i + 1)));
+  }
+  for (const auto &e : edges) {
+    EXPECT_LT(e.first, e.second);
+  }
+  EXPECT_LT(edges.size(), ids.size() * 4);
+}
+
+TEST(ChristofidesMatching, Sparse) {
+  std::mt19937 random(4423);
+  tsp::EuclidMatrix mtx;
+  mtx.generate(300, random);
+  std::vector<int> cycle(mtx.size1());
+  tsp::christofides(mtx, cycle, mtx.size1(), "",
+                    static_cast<std::vector<tsp::Point>*>(nullptr),
+                    tsp::kMatchingSparse, 5);
+  std::sort(cycle.begin(), cycle.end());
+  for (size_t i = 0; i < cycle.size(); ++i) {
+    EXPECT_EQ(i, cycle[i]);
+  }
+}
+
+TEST(ChristofidesMatching, Greedy) {
+  std::mt19937 random(5125);
+  tsp::EuclidMatrix mtx;
+  mtx.generate(400, random);
+  std::vector<int> ids;
+  for (int i = 0; i < 400; i += 2) {
+    ids.push_back(i);
+  }
+  boost::numeric::ublas::matrix<double> explicit_mtx(400, 400);
+  for (size_t i = 0; i < 400; ++i) {
+    for (size_t j = 0; j < 400; ++j) {
+      explicit_mtx(i, j) = mtx(i, j);
+    }
+  }
+  std::vector<int> mate, explicit_mate;
+  tsp::greedy_matching(mtx, ids, 8, mate);
+  tsp::greedy_matching(explicit_mtx, ids, 8, explicit_mate);
+  for (const std::vector<int> &m : {mate, explicit_mate}) {
+    ASSERT_EQ(ids.size(), m.size());
+    double weight = 0, trivial = 0;
+    for (size_t i = 0; i < m.size(); ++i) {
+      ASSERT_NE(int(i), m[i]);
+      ASSERT_EQ(int(i), m[m[i]]);
+      weight += mtx(ids[i], ids[m[i]]) / 2;
+    }
+    for (size_t i = 0; i < m.size(); i += 2) {
+      trivial += mtx(ids[i], ids[i + 1]);
+    }
+    // about .3 * sqrt(n) for a near optimal matching
+    EXPECT_LT(weight, .5 * sqrt(ids.size()));
+    EXPECT_LT(weight, trivial / 5);
+  }
+}
+
+TEST(ChristofidesMatching, GreedyChristofides) {
+  std::mt19937 random(4423);
+  tsp::EuclidMatrix mtx;
+  mtx.generate(2000, random);
+  std::vector<int> cycle(mtx.size1());
+  tsp::christofides(mtx, cycle, mtx.size1(), "",
+                    static_cast<std::vector<tsp::Point>*>(nullptr),
+                    tsp::kMatchingGreedy);
+  // random uniform instance: optimum is about .7124 * sqrt(n * area)
+  EXPECT_LT(tsp::fitness(mtx, cycle), 1.3 * .7124 * sqrt(mtx.size1()));
+  std::sort(cycle.begin(), cycle.end());
+  for (size_t i = 0; i < cycle.size(); ++i) {
+    EXPECT_EQ(i, cycle[i]);
+  }
+}
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "paal/ProgressCtrl.h"
+#include "paal/StepCtrl.h"
+#include "paal/Logger.h"
+#include "paal/search.h"
+#include "tsp/EuclidMatrix.h"
+#include "tsp/LinKernighanWalker.h"
+#include "tsp/NeighborTwoOptWalker.h"
+#include "tsp/util.h"
+
+TEST(tsp_LinKernighanWalker, fitness_consistency)
+{
+  std::mt19937 random(4123);
+  for (size_t n : { 5, 6, 12, 60 })
+  {
+    tsp::EuclidMatrix m;
+    m.generate(n, random);
+    tsp::NeighborLists lists;
+    tsp::neighbor_lists(m, 5, lists);
+    std::vector<size_t> c;
+    tsp::cycle_shuffle(c, m.size1(), random);
+    tsp::LinKernighanWalker<tsp::EuclidMatrix> walker(m, lists, c, 4);
+    const rsarray::RSArray<size_t> &tour = walker.cycle;
+    EXPECT_DOUBLE_EQ(tsp::fitness(m, c), walker.current_fitness());
+    for (size_t i = 0; i < 500; ++i)
+    {
+      walker.prepare_step(0, random);
+      EXPECT_NEAR(walker.current_fitness(), tsp::fitness(m, tour), 1e-9);
+      if (i % 3) walker.make_step();
+      EXPECT_NEAR(tsp::fitness(m, tour), walker.current_fitness(), 1e-9);
+      std::vector<size_t> sorted(n);
+      for (size_t j = 0; j < n; ++j) sorted[j] = tour[j];
+      std::sort(sorted.begin(), sorted.end());
+      for (size_t j = 0; j < n; ++j) ASSERT_EQ(j, sorted[j]);
+    }
+  }
+}
+
+TEST(tsp_LinKernighanWalker, hill_climb)
+{
+  enum { n = 1000, it = 50000 };
+  std::mt19937 random(2734);
+  tsp::EuclidMatrix m;
+  m.generate(n, random);
+  tsp::NeighborLists lists;
+  tsp::neighbor_lists(m, 8, lists);
+  std::vector<size_t> c;
+  tsp::cycle_shuffle(c, m.size1(), random);
+  paal::HillClimb step_ctrl;
+  paal::VoidLogger logger;
+
+  tsp::LinKernighanWalker<tsp::EuclidMatrix> walker(m, lists, c);
+  paal::IterationCtrl progress_ctrl(it);
+  paal::search(walker, random, progress_ctrl, step_ctrl, logger);
+  const rsarray::RSArray<size_t> &tour = walker.cycle;
+  EXPECT_NEAR(tsp::fitness(m, tour), walker.current_fitness(), 1e-6);
+
+  tsp::NeighborTwoOptWalker<tsp::EuclidMatrix> two_opt(m, lists, c);
+  paal::IterationCtrl two_opt_progress_ctrl(it);
+  paal::search(two_opt, random, two_opt_progress_ctrl, step_ctrl, logger);
+  // random uniform instance: optimum is about .7124 * sqrt(n * area)
+  EXPECT_LT(walker.current_fitness(), 1.15 * .7124 * sqrt(n));
+  EXPECT_LT(walker.current_fitness(), two_opt.current_fitness());
+}
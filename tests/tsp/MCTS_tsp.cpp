@@ -2,11 +2,16 @@
 
 #include <mcts/MonteCarloTree.h>
 #include <mcts/Policy.h>
+#include <tsp/EuclidMatrix.h>
 #include <tsp/TSPLIB.h>
 #include <tsp/MCTS_tsp.h>
 #include <paal/ProgressCtrl.h>
 
+#include <algorithm>
+#include <limits>
+#include <numeric>
 #include <random>
+#include <vector>
 #include <iostream>  // NOLINT(readability/streams)
 
 template<typename State, typename Policy>
@@ -38,7 +43,8 @@ typedef ::testing::Types <
     mcts::PolicyMuSigma<Random>,
     mcts::PolicyRandMean<Random>,
     mcts::PolicyEpsMean<Random>,
-    mcts::PolicyEpsBest<Random>
+    mcts::PolicyEpsBest<Random>,
+    mcts::PolicyUCT<Random>
   > PoliciesList;
 TYPED_TEST_CASE(MCTS_Policy, PoliciesList);
 
@@ -60,3 +66,211 @@ TYPED_TEST(MCTS_Policy, Performance_eil51)
   std::cout << "samples: " << samples << " res: " << mct.root_state().cost_
     << std::endl;
 }
+
+/** cheapest cycle through the last vertex and vertices in left, starting
+ * with the path through prefix */
+double brute_force(const tsp::EuclidMatrix &m, std::vector<size_t> prefix,
+    std::vector<size_t> left)
+{
+  size_t first = m.size1() - 1;
+  double prefix_cost = 0;
+  size_t last = first;
+  for (size_t v : prefix)
+  {
+    prefix_cost += m(last, v);
+    last = v;
+  }
+  double best = std::numeric_limits<double>::infinity();
+  std::sort(left.begin(), left.end());
+  do
+  {
+    double cost = prefix_cost;
+    size_t u = last;
+    for (size_t v : left)
+    {
+      cost += m(u, v);
+      u = v;
+    }
+    best = std::min(best, cost + m(u, first));
+  }
+  while (std::next_permutation(left.begin(), left.end()));
+  return best;
+}
+
+TEST(tsp_TSPState, exhaustive_search_min)
+{
+  std::mt19937 random(4112);
+  for (size_t n = 2; n <= 10; n++)
+  {
+    tsp::EuclidMatrix m;
+    m.generate(n, random);
+    std::vector<size_t> all(n - 1);
+    std::iota(all.begin(), all.end(), 0);
+    for (size_t applied = 0; applied < n - 1; applied++)
+    {
+      tsp::TSPState<tsp::EuclidMatrix> state(m);
+      std::vector<size_t> prefix(all.begin(), all.begin() + applied);
+      for (size_t v : prefix) state.apply(v);
+      state.exhaustive_search_min();
+      EXPECT_TRUE(state.is_terminal());
+      EXPECT_NEAR(brute_force(m, prefix,
+            std::vector<size_t>(all.begin() + applied, all.end())),
+          state.cost_, 1e-9) << n << " " << applied;
+    }
+  }
+}
+
+TEST(tsp_TSPState, exhaustive_search_min_large)
+{
+  std::mt19937 random(871);
+  tsp::EuclidMatrix m;
+  m.generate(tsp::TSPState<tsp::EuclidMatrix>::kExhaustiveMax + 1, random);
+  tsp::TSPState<tsp::EuclidMatrix> state(m);
+  std::vector<size_t> cycle(m.size1());
+  std::iota(cycle.begin(), cycle.end(), 0);
+  // optimum is not worse than any cycle
+  state.exhaustive_search_min();
+  EXPECT_LE(state.cost_, tsp::fitness(m, cycle) + 1e-9);
+
+  // and no better than a playout
+  tsp::TSPState<tsp::EuclidMatrix> other(m);
+  for (int i = 0; i < 10; i++)
+  {
+    tsp::TSPState<tsp::EuclidMatrix> playout(other);
+    EXPECT_GE(playout.estimate_playout(random), state.cost_ - 1e-9);
+  }
+}
+
+TEST(tsp_TSPState, undo)
+{
+  std::mt19937 random(1029);
+  tsp::EuclidMatrix m;
+  m.generate(12, random);
+  typedef tsp::TSPState<tsp::EuclidMatrix> State;
+  State state(m);
+  std::vector<State::Undo> undos;
+  std::vector<double> costs;
+  std::vector<size_t> lefts;
+  while (!state.is_terminal())
+  {
+    costs.push_back(state.cost_);
+    lefts.push_back(state.left_decisions());
+    undos.push_back(state.apply(state.moves()[random() % state.moves().size()]));
+  }
+  while (!undos.empty())
+  {
+    state.undo(undos.back());
+    undos.pop_back();
+    EXPECT_EQ(costs.back(), state.cost_);
+    EXPECT_EQ(lefts.back(), state.left_decisions());
+    costs.pop_back();
+    lefts.pop_back();
+  }
+  EXPECT_EQ(m.size1() - 1, state.moves().size());
+
+  // playouts leave the state unchanged
+  state.apply(3);
+  for (int i = 0; i < 5; i++) state.estimate_playout(random);
+  EXPECT_EQ(m.size1() - 2, state.left_decisions());
+  EXPECT_EQ(m(m.size1() - 1, 3), state.cost_);
+}
+
+TEST(tsp_TSPState, search)
+{
+  std::mt19937 random(77);
+  tsp::EuclidMatrix m;
+  m.generate(30, random);
+  typedef tsp::TSPState<tsp::EuclidMatrix> State;
+  typedef mcts::PolicyRandMean<std::mt19937> Policy;
+  State state(m);
+  Policy policy(random);
+  auto mct = run_mcts(state, policy, 200);
+  EXPECT_TRUE(mct.root_state().is_terminal());
+  EXPECT_LT(0, mct.root_state().cost_);
+}
+
+TEST(tsp_TSPState, hash)
+{
+  std::mt19937 random(5);
+  tsp::EuclidMatrix m;
+  m.generate(8, random);
+  typedef tsp::TSPState<tsp::EuclidMatrix> State;
+  State a(m), b(m), c(m);
+  uint64_t initial = a.hash();
+  uint64_t after = a.hash(0);
+  a.apply(0);
+  EXPECT_EQ(after, a.hash());
+  a.apply(1);
+  a.apply(2);
+  b.apply(1);
+  b.apply(0);
+  b.apply(2);
+  // the same vertices and the same last one
+  EXPECT_EQ(a.hash(), b.hash());
+  c.apply(0);
+  c.apply(2);
+  c.apply(1);
+  EXPECT_NE(a.hash(), c.hash());
+  // transposition after one more move
+  State::Undo undo = c.apply(3);
+  EXPECT_EQ(a.hash(3), c.hash());
+  c.undo(undo);
+  EXPECT_NE(a.hash(), c.hash());
+
+  State d(m);
+  std::vector<State::Undo> undos;
+  for (size_t v : {4, 2, 6})
+  {
+    mcts::Fitness cost = d.cost(v);
+    undos.push_back(d.apply(v));
+    EXPECT_DOUBLE_EQ(cost, d.cost_);
+  }
+  while (!undos.empty())
+  {
+    d.undo(undos.back());
+    undos.pop_back();
+  }
+  EXPECT_EQ(initial, d.hash());
+}
+
+TEST(tsp_TSPState, cost)
+{
+  std::mt19937 random(8);
+  tsp::EuclidMatrix m;
+  m.generate(4, random);
+  tsp::TSPState<tsp::EuclidMatrix> state(m);
+  for (size_t v : {2, 0, 1})
+  {
+    mcts::Fitness cost = state.cost(v);
+    state.apply(v);
+    EXPECT_DOUBLE_EQ(cost, state.cost_);
+  }
+  // the last move closes the cycle
+  EXPECT_TRUE(state.is_terminal());
+}
+
+TEST(tsp_TSPState, moves_count)
+{
+  std::mt19937 random(6);
+  tsp::EuclidMatrix m;
+  m.generate(30, random);
+  typedef tsp::TSPState<tsp::EuclidMatrix> State;
+  State state(m);
+  state.apply(4);
+  std::vector<State::Move> all = state.moves(100);
+  ASSERT_EQ(28u, all.size());
+  for (size_t i = 1; i < all.size(); i++)
+    EXPECT_LE(m(4, all[i - 1]), m(4, all[i]));
+  for (size_t count : {1, 5, 17})
+  {
+    std::vector<State::Move> some = state.moves(count);
+    ASSERT_EQ(count, some.size());
+    EXPECT_TRUE(std::equal(some.begin(), some.end(), all.begin()));
+  }
+  // the moves are those of moves()
+  std::vector<State::Move> sorted = state.moves();
+  std::sort(all.begin(), all.end());
+  EXPECT_EQ(sorted, all);
+  State limited(m, 6);
+  EXPECT_EQ(6u, limited.moves(10).size());
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+
+#include "tsp/MappedFile.h"
+#include "./format.h"
+
+inline tsp::TextScanner scanner(const std::string &s)
+{
+  return tsp::TextScanner(s.data(), s.data() + s.size());
+}
+
+TEST(tsp_TextScanner, words_and_lines)
+{
+  std::string text = "NAME : a280\r\n  TYPE: TSP  \nNODE_COORD_SECTION\n1 2";
+  tsp::TextScanner is = scanner(text);
+  EXPECT_EQ("NAME : a280", is.line());
+  EXPECT_TRUE(is.skip_space());
+  EXPECT_EQ("TYPE: TSP", is.line());
+  EXPECT_EQ("NODE_COORD_SECTION", is.word());
+  EXPECT_EQ("1", is.word());
+  EXPECT_EQ("2", is.word());
+  EXPECT_FALSE(is.skip_space());
+  EXPECT_EQ("", is.word());
+}
+
+TEST(tsp_TextScanner, integers)
+{
+  // no terminating '\0' after the last digit
+  std::string text = "12 -7 +3 0 x 5";
+  tsp::TextScanner is = scanner(text.substr(0, text.size()));
+  int x;
+  ASSERT_TRUE(is.read(x));
+  EXPECT_EQ(12, x);
+  ASSERT_TRUE(is.read(x));
+  EXPECT_EQ(-7, x);
+  ASSERT_TRUE(is.read(x));
+  EXPECT_EQ(3, x);
+  ASSERT_TRUE(is.read(x));
+  EXPECT_EQ(0, x);
+  EXPECT_FALSE(is.read(x));
+  EXPECT_EQ("x", is.word());
+  ASSERT_TRUE(is.read(x));
+  EXPECT_EQ(5, x);
+  EXPECT_FALSE(is.read(x));
+}
+
+TEST(tsp_TextScanner, doubles_match_strtod)
+{
+  std::mt19937 random(4412);
+  std::uniform_real_distribution<double> uniform(-1e6, 1e6);
+  const char *formats[] = { "%.0f", "%.3f", "%.10f", "%e", "%.17g",
+    "%.15e", "%g" };
+  for (size_t i = 0; i < 5000; ++i)
+  {
+    char buf[64];
+    double v = uniform(random) * (i % 3 ? 1 : 1e-7);
+    snprintf(buf, sizeof(buf), formats[i % 7], v);
+    std::string s(buf);
+    tsp::TextScanner is = scanner(s);
+    double x;
+    ASSERT_TRUE(is.read(x)) << s;
+    EXPECT_EQ(strtod(buf, nullptr), x) << s;
+  }
+  for (std::string s : { "0", "-0.0", "1e5", "2.5E-3", "007.50", ".5",
+         "123456789012345678901234567890", "0.000000000000000000000001" })
+  {
+    tsp::TextScanner is = scanner(s);
+    double x;
+    ASSERT_TRUE(is.read(x)) << s;
+    EXPECT_EQ(strtod(s.c_str(), nullptr), x) << s;
+  }
+  for (std::string s : { "", "-", "e5", "1e", "1.5x", "." })
+  {
+    tsp::TextScanner is = scanner(s);
+    double x;
+    EXPECT_FALSE(is.read(x)) << s;
+  }
+}
+
+TEST(tsp_MappedFile, contents)
+{
+  std::string path = format("/tmp/tsp_MappedFile.%", getpid());
+  {
+    std::ofstream os(path.c_str());
+    os << "hello 42";
+  }
+  {
+    tsp::MappedFile file(path);
+    EXPECT_EQ("hello 42", std::string(file.begin(), file.end()));
+  }
+  {
+    std::ofstream os(path.c_str(), std::ios::trunc);
+  }
+  {
+    tsp::MappedFile file(path);
+    EXPECT_EQ(0u, file.size());
+  }
+  remove(path.c_str());
+  EXPECT_THROW(tsp::MappedFile file(path), std::runtime_error);
+}
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "tsp/EuclidMatrix.h"
+#include "tsp/NeighborLists.h"
+
+TEST(tsp_NeighborLists, scan)
+{
+  tsp::EuclidMatrix m;
+  m.pos = { tsp::Point(0, 0), tsp::Point(1, 0), tsp::Point(3, 0),
+            tsp::Point(7, 0) };
+  tsp::NeighborLists lists;
+  tsp::neighbor_lists_scan(m, 2, lists);
+  EXPECT_EQ(4, lists.size());
+  std::vector<uint32_t> expected = { 1, 2, 0, 2, 1, 0, 2, 1 };
+  EXPECT_EQ(expected, lists.ids);
+  tsp::neighbor_lists_scan(m, 10, lists);
+  EXPECT_EQ(3, lists.k);
+}
+
+TEST(tsp_NeighborLists, grid_equals_scan)
+{
+  std::mt19937 random(8273);
+  for (size_t n : { 2, 10, 100, 1000 })
+  {
+    tsp::EuclidMatrix m;
+    m.generate(n, random);
+    tsp::NeighborLists grid, scan;
+    tsp::neighbor_lists(m, 8, grid);
+    tsp::neighbor_lists_scan(m, 8, scan);
+    EXPECT_EQ(scan.k, grid.k);
+    EXPECT_EQ(scan.ids, grid.ids);
+  }
+}
+
+TEST(tsp_NeighborLists, clustered)
+{
+  tsp::EuclidMatrix m;
+  for (size_t i = 0; i < 50; ++i)
+  {
+    m.pos.push_back(tsp::Point(i * 1e-3, 0));
+    m.pos.push_back(tsp::Point(1 + i * 1e-3, 1));
+  }
+  tsp::NeighborLists grid, scan;
+  tsp::neighbor_lists_grid(m.pos, 5, grid);
+  tsp::neighbor_lists_scan(m, 5, scan);
+  EXPECT_EQ(scan.ids, grid.ids);
+}
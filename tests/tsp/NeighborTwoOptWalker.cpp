@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "paal/ProgressCtrl.h"
+#include "paal/StepCtrl.h"
+#include "paal/Logger.h"
+#include "paal/search.h"
+#include "tsp/EuclidMatrix.h"
+#include "tsp/NeighborTwoOptWalker.h"
+#include "tsp/TwoOptWalker.h"
+#include "tsp/util.h"
+
+TEST(tsp_NeighborTwoOptWalker, fitness_consistency)
+{
+  std::mt19937 random(92834);
+  tsp::EuclidMatrix m;
+  m.generate(50, random);
+  tsp::NeighborLists lists;
+  tsp::neighbor_lists(m, 5, lists);
+  std::vector<size_t> c;
+  tsp::cycle_shuffle(c, m.size1(), random);
+  tsp::NeighborTwoOptWalker<tsp::EuclidMatrix> walker(m, lists, c);
+  EXPECT_DOUBLE_EQ(tsp::fitness(m, c), walker.current_fitness());
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    walker.prepare_step(0, random);
+    if (i % 3) walker.make_step();
+    EXPECT_NEAR(tsp::fitness(m, walker.cycle), walker.current_fitness(), 1e-9);
+    for (size_t j = 0; j < walker.cycle.size(); ++j)
+      ASSERT_EQ(j, walker.pos[walker.cycle[j]]);
+  }
+}
+
+TEST(tsp_NeighborTwoOptWalker, hill_climb)
+{
+  enum { n = 1000, it = 200000 };
+  std::mt19937 random(2734);
+  tsp::EuclidMatrix m;
+  m.generate(n, random);
+  tsp::NeighborLists lists;
+  tsp::neighbor_lists(m, 8, lists);
+  std::vector<size_t> c;
+  tsp::cycle_shuffle(c, m.size1(), random);
+  paal::HillClimb step_ctrl;
+  paal::VoidLogger logger;
+
+  tsp::NeighborTwoOptWalker<tsp::EuclidMatrix> walker(m, lists, c);
+  paal::IterationCtrl progress_ctrl(it);
+  paal::search(walker, random, progress_ctrl, step_ctrl, logger);
+  EXPECT_NEAR(tsp::fitness(m, walker.cycle), walker.current_fitness(), 1e-6);
+
+  tsp::TwoOptWalker<tsp::EuclidMatrix> plain(m, c);
+  paal::IterationCtrl plain_progress_ctrl(it);
+  paal::search(plain, random, plain_progress_ctrl, step_ctrl, logger);
+  // random uniform instance: optimum is about .7124 * sqrt(n * area)
+  EXPECT_LT(walker.current_fitness(), 1.25 * .7124 * sqrt(n));
+  EXPECT_LT(walker.current_fitness(), plain.current_fitness());
+}
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "paal/ProgressCtrl.h"
+#include "paal/StepCtrl.h"
+#include "paal/Logger.h"
+#include "paal/search.h"
+#include "tsp/EuclidMatrix.h"
+#include "tsp/OrOptWalker.h"
+#include "tsp/util.h"
+
+typedef tsp::OrOptWalker<tsp::EuclidMatrix> Walker;
+
+TEST(tsp_OrOptWalker, fitness_consistency)
+{
+  std::mt19937 random(723894);
+  for (size_t n : { 4, 5, 9, 40 })
+  {
+    tsp::EuclidMatrix m;
+    m.generate(n, random);
+    std::vector<size_t> c;
+    tsp::cycle_shuffle(c, n, random);
+    Walker walker(m, c);
+    EXPECT_DOUBLE_EQ(tsp::fitness(m, c), walker.current_fitness());
+    for (size_t i = 0; i < 500; ++i)
+    {
+      walker.prepare_step(0, random);
+      if (i & 1) walker.make_step();
+      ASSERT_NEAR(tsp::fitness(m, walker.cycle), walker.current_fitness(),
+          1e-9);
+      std::vector<size_t> sorted(walker.cycle);
+      std::sort(sorted.begin(), sorted.end());
+      for (size_t j = 0; j < n; ++j) ASSERT_EQ(j, sorted[j]);
+    }
+  }
+}
+
+TEST(tsp_OrOptWalker, search)
+{
+  std::mt19937 random(1234);
+  tsp::EuclidMatrix m;
+  m.generate(100, random);
+  std::vector<size_t> c;
+  tsp::cycle_shuffle(c, m.size1(), random);
+  paal::VoidLogger logger;
+
+  Walker hill(m, c);
+  paal::IterationCtrl hill_progress_ctrl(100000);
+  paal::HillClimb hill_step_ctrl;
+  paal::search(hill, random, hill_progress_ctrl, hill_step_ctrl, logger);
+  EXPECT_LT(hill.current_fitness(), tsp::fitness(m, c) / 2);
+  EXPECT_NEAR(tsp::fitness(m, hill.cycle), hill.current_fitness(), 1e-6);
+
+  Walker anne(m, c);
+  paal::IterationCtrl anne_progress_ctrl(100000);
+  paal::Annealing anne_step_ctrl(tsp::fitness(m, c) / m.size1(), 1e-5);
+  paal::search(anne, random, anne_progress_ctrl, anne_step_ctrl, logger);
+  EXPECT_LT(anne.current_fitness(), tsp::fitness(m, c) / 2);
+  EXPECT_NEAR(tsp::fitness(m, anne.cycle), anne.current_fitness(), 1e-6);
+}
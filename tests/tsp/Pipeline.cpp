@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "paal/ProgressCtrl.h"
+#include "paal/StepCtrl.h"
+#include "tsp/EuclidMatrix.h"
+#include "tsp/Pipeline.h"
+#include "tsp/QueueTwoOptWalker.h"
+#include "tsp/TwoOptWalker.h"
+#include "tsp/util.h"
+
+typedef tsp::Pipeline<tsp::EuclidMatrix> Pipeline;
+
+inline bool is_cycle(const std::vector<size_t> &cycle, size_t n)
+{
+  std::vector<size_t> sorted(cycle);
+  std::sort(sorted.begin(), sorted.end());
+  for (size_t i = 0; i < sorted.size(); ++i)
+    if (sorted[i] != i) return false;
+  return sorted.size() == n;
+}
+
+TEST(tsp_Pipeline, construct)
+{
+  std::mt19937 random(2391);
+  tsp::EuclidMatrix m;
+  m.generate(300, random);
+  Pipeline pipeline(m);
+  for (tsp::ConstructionEnum how : {tsp::kConstructGreedy,
+         tsp::kConstructChristofides, tsp::kConstructSpaceFillingCurve,
+         tsp::kConstructGreedyEdge})
+  {
+    pipeline.construct_cycle(how);
+    EXPECT_TRUE(is_cycle(pipeline.cycle, m.size1())) << how;
+    EXPECT_GE(pipeline.circuit.size(), m.size1()) << how;
+  }
+  EXPECT_GE(pipeline.times.construct, 0);
+  EXPECT_GE(pipeline.times.shortcut, 0);
+  EXPECT_EQ(0, pipeline.times.improve);
+}
+
+TEST(tsp_Pipeline, christofides_matches_direct_call)
+{
+  std::mt19937 random(6712);
+  tsp::EuclidMatrix m;
+  m.generate(200, random);
+  Pipeline pipeline(m);
+  pipeline.construct_cycle(tsp::kConstructChristofides);
+  std::vector<size_t> direct(m.size1());
+  tsp::christofides(m, direct, m.size1(), "",
+      (std::vector<tsp::Point>*)nullptr, tsp::kMatchingGreedy);
+  EXPECT_EQ(direct, pipeline.cycle);
+}
+
+TEST(tsp_Pipeline, improve)
+{
+  std::mt19937 random(5123);
+  tsp::EuclidMatrix m;
+  m.generate(500, random);
+  Pipeline pipeline(m);
+  pipeline.construct_cycle(tsp::kConstructSpaceFillingCurve);
+  double constructed = tsp::fitness(m, pipeline.cycle);
+
+  typedef tsp::QueueTwoOptWalker<tsp::EuclidMatrix> Walker;
+  Walker walker(m, pipeline.neighbors(8), pipeline.cycle);
+  paal::IterationCtrl iterations(1000000);
+  paal::ConvergenceCtrl<Walker, paal::IterationCtrl>
+    progress_ctrl(walker, iterations);
+  paal::HillClimb step_ctrl;
+  double improved = pipeline.improve(walker, random, progress_ctrl, step_ctrl);
+  EXPECT_TRUE(walker.converged());
+  EXPECT_LT(improved, constructed);
+  EXPECT_TRUE(is_cycle(pipeline.cycle, m.size1()));
+  EXPECT_NEAR(improved, tsp::fitness(m, pipeline.cycle), 1e-6);
+
+  // a further stage starts from the improved cycle
+  tsp::TwoOptWalker<tsp::EuclidMatrix> two_opt(m, pipeline.cycle);
+  paal::IterationCtrl budget(1000);
+  EXPECT_LE(pipeline.improve(two_opt, random, budget, step_ctrl),
+      improved + 1e-9);
+  EXPECT_GE(pipeline.times.improve, 0);
+  EXPECT_DOUBLE_EQ(pipeline.times.construct + pipeline.times.shortcut +
+      pipeline.times.improve, pipeline.times.total());
+}
+
+TEST(tsp_Pipeline, neighbors_reused)
+{
+  std::mt19937 random(913);
+  tsp::EuclidMatrix m;
+  m.generate(50, random);
+  Pipeline pipeline(m);
+  const tsp::NeighborLists *lists = &pipeline.neighbors(5);
+  EXPECT_EQ(5u, lists->k);
+  EXPECT_EQ(lists->ids.data(), pipeline.neighbors(5).ids.data());
+  EXPECT_EQ(7u, pipeline.neighbors(7).k);
+}
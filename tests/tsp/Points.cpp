@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "tsp/EuclidMatrix.h"
+#include "tsp/Points.h"
+
+TEST(tsp_Points, swap_remove)
+{
+  std::vector<tsp::Point> pos = { {0, 1}, {2, 3}, {4, 5} };
+  tsp::Points points(pos);
+  points.swap_remove(0);
+  ASSERT_EQ(2, points.size());
+  EXPECT_EQ(2, points.id[0]);
+  EXPECT_EQ(4, points[0].x);
+  EXPECT_EQ(3, points[1].y);
+}
+
+TEST(tsp_Points, kernels)
+{
+  std::mt19937 random(7812);
+  for (size_t n = 1; n < 40; ++n)
+  {
+    tsp::EuclidMatrix m;
+    m.generate(n, random);
+    tsp::Points points(m.pos);
+    tsp::Point p(.5, .5);
+    std::vector<double> d(n);
+    tsp::sqr_distances(&points.x[0], &points.y[0], n, p, &d[0]);
+    size_t best = 0;
+    for (size_t j = 0; j < n; ++j)
+    {
+      ASSERT_DOUBLE_EQ((m.pos[j] - p).sqr(), d[j]);
+      if (d[j] < d[best]) best = j;
+    }
+    EXPECT_EQ(best, tsp::argmin_sqr_distance(
+          &points.x[0], &points.y[0], n, p));
+    EXPECT_EQ(best, tsp::argmin(&d[0], n));
+  }
+}
+
+TEST(tsp_Points, argmin_ties)
+{
+  std::vector<double> v = { 3, 2, 5, 1, 7, 1, 1, 4, 1 };
+  for (size_t n = 4; n <= v.size(); ++n) EXPECT_EQ(3, tsp::argmin(&v[0], n));
+  std::vector<double> x(9, 1), y(9, 1);
+  EXPECT_EQ(0, tsp::argmin_sqr_distance(&x[0], &y[0], 9, tsp::Point(0, 0)));
+}
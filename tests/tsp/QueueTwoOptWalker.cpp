@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "paal/ProgressCtrl.h"
+#include "paal/StepCtrl.h"
+#include "paal/Logger.h"
+#include "paal/search.h"
+#include "tsp/EuclidMatrix.h"
+#include "tsp/NeighborTwoOptWalker.h"
+#include "tsp/QueueTwoOptWalker.h"
+#include "tsp/util.h"
+
+typedef tsp::QueueTwoOptWalker<tsp::EuclidMatrix> Walker;
+
+TEST(tsp_QueueTwoOptWalker, fitness_consistency)
+{
+  std::mt19937 random(7233);
+  tsp::EuclidMatrix m;
+  m.generate(60, random);
+  tsp::NeighborLists lists;
+  tsp::neighbor_lists(m, 6, lists);
+  std::vector<size_t> c;
+  tsp::cycle_shuffle(c, m.size1(), random);
+  Walker walker(m, lists, c);
+  EXPECT_DOUBLE_EQ(tsp::fitness(m, c), walker.current_fitness());
+  while (!walker.converged())
+  {
+    walker.prepare_step(0, random);
+    EXPECT_LE(walker.next_fitness(), walker.current_fitness());
+    walker.make_step();
+    EXPECT_NEAR(tsp::fitness(m, walker.cycle), walker.current_fitness(), 1e-9);
+    for (size_t j = 0; j < walker.cycle.size(); ++j)
+      ASSERT_EQ(j, walker.pos[walker.cycle[j]]);
+  }
+}
+
+TEST(tsp_QueueTwoOptWalker, converges)
+{
+  enum { n = 2000 };
+  std::mt19937 random(2734);
+  tsp::EuclidMatrix m;
+  m.generate(n, random);
+  tsp::NeighborLists lists;
+  tsp::neighbor_lists(m, 8, lists);
+  std::vector<size_t> c;
+  tsp::cycle_shuffle(c, m.size1(), random);
+  paal::HillClimb step_ctrl;
+  paal::CountingLogger logger;
+
+  Walker walker(m, lists, c);
+  paal::IterationCtrl iteration_ctrl(100 * n);
+  paal::ConvergenceCtrl<Walker, paal::IterationCtrl> progress_ctrl(
+      walker, iteration_ctrl);
+  paal::search(walker, random, progress_ctrl, step_ctrl, logger);
+  EXPECT_TRUE(walker.converged());
+  EXPECT_LT(iteration_ctrl.passed_it, iteration_ctrl.available_it);
+  EXPECT_NEAR(tsp::fitness(m, walker.cycle), walker.current_fitness(), 1e-6);
+  // random uniform instance: optimum is about .7124 * sqrt(n * area)
+  EXPECT_LT(walker.current_fitness(), 1.2 * .7124 * sqrt(n));
+
+  // the result is a local optimum
+  Walker again(m, lists, walker.cycle);
+  again.prepare_step(0, random);
+  EXPECT_TRUE(again.converged());
+}
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "tsp/EuclidMatrix.h"
+#include "tsp/SpaceFillingCurve.h"
+#include "tsp/util.h"
+
+TEST(tsp_SpaceFillingCurve, hilbert_index)
+{
+  // order 1: (0,0) (0,1) (1,1) (1,0)
+  EXPECT_EQ(0, tsp::hilbert_index(0, 0, 1));
+  EXPECT_EQ(1, tsp::hilbert_index(0, 1, 1));
+  EXPECT_EQ(2, tsp::hilbert_index(1, 1, 1));
+  EXPECT_EQ(3, tsp::hilbert_index(1, 0, 1));
+  // consecutive cells are adjacent and all cells are visited
+  enum { order = 4, side = 1 << order };
+  std::vector<int> x(side * side, -1), y(side * side, -1);
+  for (int i = 0; i < side; ++i)
+    for (int j = 0; j < side; ++j)
+    {
+      uint64_t d = tsp::hilbert_index(i, j, order);
+      ASSERT_LT(d, side * side);
+      ASSERT_EQ(-1, x[d]);
+      x[d] = i;
+      y[d] = j;
+    }
+  for (int d = 1; d < side * side; ++d)
+    EXPECT_EQ(1, abs(x[d] - x[d - 1]) + abs(y[d] - y[d - 1]));
+}
+
+TEST(tsp_SpaceFillingCurve, hilbert_sort)
+{
+  enum { n = 5000 };
+  std::mt19937 random(3414);
+  tsp::EuclidMatrix m;
+  m.generate(n, random);
+  std::vector<uint32_t> order;
+  tsp::hilbert_sort(m.pos, order);
+  std::vector<uint32_t> sorted(order);
+  std::sort(sorted.begin(), sorted.end());
+  for (size_t i = 0; i < n; ++i) ASSERT_EQ(i, sorted[i]);
+  // the curve tour is within 25% of the 0.92 * sqrt(n) expected length
+  // of a space filling curve tour on a uniform instance
+  std::vector<size_t> cycle(order.begin(), order.end());
+  EXPECT_LT(tsp::fitness(m, cycle), 1.25 * .92 * sqrt(n));
+}
@@ -1,8 +1,18 @@
 #include <gtest/gtest.h>
 
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #include "tsp/TSPLIB.h"
+#include "tsp/util.h"
+#include "./format.h"
 
 TEST(TSPLIB_Matrix, constructor)
 {
@@ -25,6 +35,46 @@ TEST(TSPLIB_Matrix, resize)
   EXPECT_EQ(m.mtx.size1(), 0);
 }
 
+/** @returns fitness of the cycle and whether the view had points */
+struct FitnessVisitor
+{
+  explicit FitnessVisitor(const std::vector<size_t> &_cycle) : cycle(_cycle) {}
+  const std::vector<size_t> &cycle;
+
+  template<typename Matrix>
+  std::pair<double, bool> operator()(const Matrix &matrix) const
+  {
+    return std::make_pair(tsp::fitness(matrix, cycle),
+        tsp::matrix_points(matrix) != nullptr);
+  }
+};
+
+TEST(TSPLIB_Matrix, with_metric)
+{
+  enum { n = 30 };
+  std::mt19937 random(5234);
+  std::vector<size_t> cycle;
+  tsp::cycle_shuffle(cycle, n, random);
+  tsp::TSPLIB_Matrix m;
+  for (tsp::TSPLIB_Matrix::Dist dist :
+      { m.eucl_dist, m.ceil_dist, m.att_dist })
+  {
+    m.resize(n, n, dist);
+    for (tsp::Point & p : m.pos)
+      p = tsp::Point(random() % 1000, random() % 1000);
+    auto res = m.with_metric(FitnessVisitor(cycle));
+    EXPECT_EQ(tsp::fitness(m, cycle), res.first);
+    EXPECT_TRUE(res.second);
+  }
+  m.resize(n, n);
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = 0; j <= i; ++j)
+      m.mtx(i, j) = m.mtx(j, i) = i == j ? 0 : random() % 1000;
+  auto res = m.with_metric(FitnessVisitor(cycle));
+  EXPECT_EQ(tsp::fitness(m, cycle), res.first);
+  EXPECT_FALSE(res.second);
+}
+
 TEST(TSPLIB_Directory, dist)
 {
   // canonical cycle lengths for symmetrical tsp problems' sample
@@ -50,3 +100,133 @@ TEST(TSPLIB_Directory, dist)
   }
   EXPECT_EQ(3, found);
 }
+
+/** writes a test case to a temporary file, removed with its cache */
+struct TempCase
+{
+  TempCase(const std::string &name, const std::string &text) :
+    graph(format("/tmp/%.%.tsp", name, getpid()), 0)
+  {
+    std::ofstream os(graph.filename.c_str());
+    os << text;
+  }
+  ~TempCase()
+  {
+    remove(graph.filename.c_str());
+    remove(graph.cache_filename().c_str());
+  }
+  tsp::TSPLIB_Directory::Graph graph;
+};
+
+inline void expect_equal(const tsp::TSPLIB_Matrix &a,
+    const tsp::TSPLIB_Matrix &b)
+{
+  ASSERT_EQ(a.size1(), b.size1());
+  EXPECT_EQ(a.dist_, b.dist_);
+  for (size_t i = 0; i < a.size1(); ++i)
+    for (size_t j = 0; j < a.size1(); ++j)
+      ASSERT_EQ(a(i, j), b(i, j));
+}
+
+TEST(TSPLIB_Directory, load_formats)
+{
+  TempCase euc("euc", "NAME : euc\nCOMMENT : x: y\nTYPE : TSP\n"
+      "DIMENSION : 3\nEDGE_WEIGHT_TYPE : EUC_2D\nNODE_COORD_SECTION\n"
+      "1 0 0\n2 3.0 4\n3 6e0 8.4\nEOF\n");
+  tsp::TSPLIB_Matrix m;
+  EXPECT_EQ("EUC_2D", euc.graph.load(m));
+  ASSERT_EQ(3u, m.size1());
+  EXPECT_EQ(5, m(0, 1));
+  EXPECT_EQ(10, m(0, 2));
+  EXPECT_DOUBLE_EQ(8.4, m.pos[2].y);
+
+  TempCase lower("lower", "NAME: lower\nTYPE: TSP\nDIMENSION: 3\n"
+      "EDGE_WEIGHT_TYPE: EXPLICIT\nEDGE_WEIGHT_FORMAT: LOWER_DIAG_ROW\n"
+      "DISPLAY_DATA_TYPE: NO_DISPLAY\nEDGE_WEIGHT_SECTION\n"
+      "0\n1 0\n2 3 0\nEOF");
+  EXPECT_EQ("EXPLICIT", lower.graph.load(m));
+  EXPECT_EQ(1, m(1, 0));
+  EXPECT_EQ(2, m(0, 2));
+  EXPECT_EQ(3, m(2, 1));
+
+  TempCase upper("upper", "DIMENSION: 3\nEDGE_WEIGHT_TYPE: EXPLICIT\n"
+      "EDGE_WEIGHT_FORMAT: UPPER_ROW\nEDGE_WEIGHT_SECTION\n1 2\n3");
+  upper.graph.load(m);
+  EXPECT_EQ(1, m(1, 0));
+  EXPECT_EQ(2, m(0, 2));
+  EXPECT_EQ(3, m(2, 1));
+  EXPECT_EQ(0, m(2, 2));
+
+  TempCase geo("geo", "DIMENSION: 2\nEDGE_WEIGHT_TYPE: GEO\n"
+      "NODE_COORD_SECTION\n1 38.24 20.42\n2 39.57 26.15\nEOF\n");
+  EXPECT_EQ("GEO", geo.graph.load(m));
+  EXPECT_EQ(m(0, 1), m(1, 0));
+  EXPECT_GT(m(0, 1), 0);
+  EXPECT_TRUE(m.pos.empty());
+
+  TempCase broken("broken", "DIMENSION: 2\nEDGE_WEIGHT_TYPE: EUC_2D\n"
+      "NODE_COORD_SECTION\n1 0 0\n2 1 x\n");
+  EXPECT_THROW(broken.graph.load(m), std::runtime_error);
+  TempCase unknown("unknown", "DIMENSION: 2\nEDGE_WEIGHT_TYPE: MAN_2D\n");
+  EXPECT_THROW(unknown.graph.load(m), std::runtime_error);
+}
+
+TEST(TSPLIB_Directory, load_cache)
+{
+  std::mt19937 random(1234);
+  std::string coords = "DIMENSION: 50\nEDGE_WEIGHT_TYPE: ATT\n"
+    "NODE_COORD_SECTION\n";
+  std::string weights = "DIMENSION: 50\nEDGE_WEIGHT_TYPE: EXPLICIT\n"
+    "EDGE_WEIGHT_FORMAT: FULL_MATRIX\nEDGE_WEIGHT_SECTION\n";
+  std::string symmetric = weights;
+  std::vector<std::vector<int> > w(50, std::vector<int>(50));
+  for (size_t i = 0; i < 50; ++i)
+  {
+    coords += format("% %.% %\n", i + 1, random() % 1000, random() % 100,
+        random() % 1000);
+    for (size_t j = 0; j < 50; ++j)
+      weights += format("% ", w[i][j] = random() % 1000);
+  }
+  for (size_t i = 0; i < 50; ++i)
+    for (size_t j = 0; j < 50; ++j)
+      symmetric += format("% ", w[std::max(i, j)][std::min(i, j)]);
+  // asymmetric weights are cached in full
+  for (const std::string & text : { coords, weights, symmetric })
+  {
+    TempCase c("cache", text);
+    tsp::TSPLIB_Matrix parsed, saved, cached;
+    std::string ewt = c.graph.load(parsed);
+    EXPECT_NE(0, access(c.graph.cache_filename().c_str(), F_OK));
+    EXPECT_EQ(ewt, c.graph.load(saved, true));
+    EXPECT_EQ(0, access(c.graph.cache_filename().c_str(), F_OK));
+    expect_equal(parsed, saved);
+    EXPECT_EQ(ewt, c.graph.load(cached, true));
+    expect_equal(parsed, cached);
+    if (parsed.dist_)
+      for (size_t i = 0; i < parsed.size1(); ++i)
+      {
+        EXPECT_EQ(parsed.pos[i].x, cached.pos[i].x);
+        EXPECT_EQ(parsed.pos[i].y, cached.pos[i].y);
+      }
+  }
+}
+
+TEST(TSPLIB_Directory, load_cache_stale)
+{
+  const char *text = "DIMENSION: 2\nEDGE_WEIGHT_TYPE: EUC_2D\n"
+    "NODE_COORD_SECTION\n1 0 0\n2 3 4\nEOF\n";
+  TempCase c("stale", text);
+  tsp::TSPLIB_Matrix m;
+  c.graph.load(m, true);
+  EXPECT_EQ(5, m(0, 1));
+  // rewritten within the same second, with the same size
+  {
+    std::ofstream os(c.graph.filename.c_str());
+    os << "DIMENSION: 2\nEDGE_WEIGHT_TYPE: EUC_2D\n"
+      "NODE_COORD_SECTION\n1 0 0\n2 6 8\nEOF\n";
+  }
+  c.graph.load(m, true);
+  EXPECT_EQ(10, m(0, 1));
+  c.graph.load(m, true);
+  EXPECT_EQ(10, m(0, 1));
+}
@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "rsarray/RSArray.h"
+#include "splay/SplayTree.h"
+#include "tsp/Tour.h"
+#include "tsp/util.h"
+
+template<typename Tour> void check_tour()
+{
+  enum { n = 50 };
+  std::mt19937 random(12387);
+  std::vector<size_t> c;
+  tsp::cycle_shuffle(c, n, random);
+  Tour tour(c);
+  for (size_t i = 0; i < 500; ++i)
+  {
+    tsp::Split split;
+    split.generate(n, random);
+    tsp::tour_reverse(tour, split.begin, split.end);
+    tsp::cycle_reverse(c, split.begin, split.end);
+    for (size_t j = 0; j < n; ++j) ASSERT_EQ(c[j], tsp::tour_at(tour, j));
+  }
+}
+
+TEST(tsp_Tour, vector)
+{
+  check_tour<std::vector<size_t> >();
+}
+
+TEST(tsp_Tour, RSArray)
+{
+  check_tour<rsarray::RSArray<size_t> >();
+}
+
+TEST(tsp_Tour, SplayTree)
+{
+  check_tour<splay::SplayTree<size_t> >();
+}
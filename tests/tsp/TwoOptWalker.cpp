@@ -4,6 +4,9 @@
 #include <boost/numeric/ublas/matrix.hpp>
 #include <random>
 
+#include "rsarray/RSArray.h"
+#include "splay/SplayTree.h"
+#include "tsp/EuclidMatrix.h"
 #include "tsp/TwoOptWalker.h"
 #include "tsp/util.h"
 
@@ -51,3 +54,38 @@ TEST(tsp_TwoOptWalker, CRASH_TEST)
   }
 }
 
+
+template<typename Tour> std::vector<double> trajectory(
+    const tsp::EuclidMatrix &m, const std::vector<size_t> &c)
+{
+  std::mt19937 random(1234);
+  tsp::TwoOptWalker<tsp::EuclidMatrix, Tour> walker(m, c);
+  std::vector<double> fitness;
+  for (size_t i = 0; i < 2000; ++i)
+  {
+    walker.prepare_step(0, random);
+    if (walker.next_fitness() < walker.current_fitness()) walker.make_step();
+    fitness.push_back(walker.current_fitness());
+  }
+  EXPECT_NEAR(tsp::fitness(m, walker.cycle), fitness.back(), 1e-9);
+  return fitness;
+}
+
+TEST(tsp_TwoOptWalker, tours)
+{
+  std::mt19937 random(5123);
+  tsp::EuclidMatrix m;
+  m.generate(100, random);
+  std::vector<size_t> c;
+  tsp::cycle_shuffle(c, m.size1(), random);
+  std::vector<double> v = trajectory<std::vector<size_t> >(m, c);
+  std::vector<double> rs = trajectory<rsarray::RSArray<size_t> >(m, c);
+  std::vector<double> sp = trajectory<splay::SplayTree<size_t> >(m, c);
+  ASSERT_EQ(v.size(), rs.size());
+  ASSERT_EQ(v.size(), sp.size());
+  for (size_t i = 0; i < v.size(); ++i)
+  {
+    EXPECT_NEAR(v[i], rs[i], 1e-9);
+    EXPECT_NEAR(v[i], sp[i], 1e-9);
+  }
+}
@@ -1,9 +1,13 @@
 #include <gtest/gtest.h>
 
-
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
 #include <boost/numeric/ublas/matrix.hpp>
 
 #include "tsp/greedy.h"
+#include "tsp/TSPLIB.h"
 
 typedef boost::numeric::ublas::matrix<int> Matrix;
 
@@ -33,3 +37,138 @@ TEST(tsp_greedy, sanity)
   std::vector<size_t> expected = { 0, 1, 4, 2, 3 };
   EXPECT_EQ(expected, cycle);
 }
+
+/** hides the type of EuclidMatrix from the greedy overload */
+struct OpaqueMatrix
+{
+  explicit OpaqueMatrix(const tsp::EuclidMatrix &_m) : m(_m) {}
+  const tsp::EuclidMatrix &m;
+  double operator()(size_t i, size_t j) const
+  {
+    return m(i, j);
+  }
+  size_t size1() const
+  {
+    return m.size1();
+  }
+};
+
+TEST(tsp_greedy, points)
+{
+  std::mt19937 random(2391);
+  for (size_t n : { 0, 1, 2, 7, 100, 2500 })
+  {
+    tsp::EuclidMatrix m;
+    m.generate(n, random);
+    std::vector<size_t> cycle, expected;
+    tsp::greedy(m, cycle);
+    tsp::greedy(OpaqueMatrix(m), expected);
+    EXPECT_EQ(expected, cycle);
+  }
+}
+
+TEST(tsp_greedy, TSPLIB_Matrix)
+{
+  std::mt19937 random(6107);
+  tsp::TSPLIB_Matrix m;
+  for (tsp::TSPLIB_Matrix::Dist dist :
+      { m.eucl_dist, m.ceil_dist, m.att_dist })
+    for (size_t n : { 1, 7, 300, 2500 })
+    {
+      m.resize(n, n, dist);
+      for (tsp::Point & p : m.pos)
+        p = tsp::Point(random() % 100000, random() % 100000);
+      std::vector<size_t> cycle, expected;
+      tsp::greedy(m, cycle);
+      tsp::greedy_scan(m, expected);
+      // rounded distances tie, and the tours part at the first tie broken
+      // differently; every step still goes to a nearest unvisited vertex
+      double scan = tsp::fitness(m, expected);
+      EXPECT_NEAR(scan, tsp::fitness(m, cycle), 0.02 * scan);
+      std::vector<bool> visited(n, false);
+      visited[cycle[0]] = true;
+      for (size_t i = 1; i < n; ++i)
+      {
+        int nearest = std::numeric_limits<int>::max();
+        for (size_t j = 0; j < n; ++j)
+          if (!visited[j]) nearest = std::min(nearest, m(cycle[i - 1], j));
+        EXPECT_EQ(nearest, m(cycle[i - 1], cycle[i]));
+        visited[cycle[i]] = true;
+      }
+    }
+}
+
+inline bool is_permutation(const std::vector<size_t> &cycle)
+{
+  std::vector<bool> seen(cycle.size(), false);
+  for (size_t v : cycle)
+  {
+    if (v >= cycle.size() || seen[v]) return false;
+    seen[v] = true;
+  }
+  return true;
+}
+
+TEST(tsp_greedy, space_filling_curve)
+{
+  std::mt19937 random(1723);
+  for (size_t n : { 0, 1, 2, 7, 1000 })
+  {
+    tsp::EuclidMatrix m;
+    m.generate(n, random);
+    std::vector<size_t> cycle;
+    tsp::space_filling_curve(m.pos, cycle);
+    EXPECT_EQ(n, cycle.size());
+    EXPECT_TRUE(is_permutation(cycle));
+  }
+}
+
+TEST(tsp_greedy, greedy_edge)
+{
+  std::mt19937 random(9182);
+  for (size_t n : { 0, 1, 2, 3, 7, 100, 3000 })
+  {
+    tsp::EuclidMatrix m;
+    m.generate(n, random);
+    std::vector<size_t> cycle, nearest, curve;
+    tsp::greedy_edge(m, cycle);
+    EXPECT_EQ(n, cycle.size());
+    EXPECT_TRUE(is_permutation(cycle));
+    // on small instances greedy edge may lose to nearest neighbour
+    if (n < 1000) continue;
+    tsp::greedy(m, nearest);
+    tsp::space_filling_curve(m.pos, curve);
+    EXPECT_LT(tsp::fitness(m, cycle), tsp::fitness(m, nearest));
+    EXPECT_LT(tsp::fitness(m, cycle), tsp::fitness(m, curve));
+  }
+}
+
+TEST(tsp_greedy, sort_by_high_bits)
+{
+  std::mt19937 random(3119);
+  for (size_t n : { 0, 1, 1000, 200000 })
+  {
+    // few distinct high bits, low bits increasing, as greedy_edge_round
+    // pushes them
+    std::vector<uint64_t> keys(n), expected;
+    for (size_t i = 0; i < n; ++i)
+      keys[i] = uint64_t(random() % 5000 * 40503) << 32 | i;
+    expected = keys;
+    std::sort(expected.begin(), expected.end());
+    tsp::sort_by_high_bits(keys);
+    EXPECT_EQ(expected, keys);
+  }
+}
+
+TEST(tsp_greedy, greedy_edge_duplicates)
+{
+  // a few distinct locations, every one repeated
+  std::mt19937 random(44);
+  tsp::EuclidMatrix m;
+  m.generate(10, random);
+  for (size_t i = 0; i < 300; ++i) m.pos.push_back(m.pos[i % 10]);
+  std::vector<size_t> cycle;
+  tsp::greedy_edge(m.pos, cycle, 3);
+  EXPECT_EQ(m.pos.size(), cycle.size());
+  EXPECT_TRUE(is_permutation(cycle));
+}
@@ -58,3 +58,19 @@ TEST(tsp_util, Split)
   }
 }
 
+
+TEST(tsp_util, Insertion)
+{
+  enum { n = 10, max_len = 3 };
+  tsp::Insertion insertion;
+  std::mt19937 random(92384);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    insertion.generate(n, max_len, random);
+    EXPECT_LT(insertion.begin, n);
+    EXPECT_LE(1, insertion.len);
+    EXPECT_LE(insertion.len, max_len);
+    EXPECT_LE(1, insertion.shift);
+    EXPECT_LT(insertion.len + insertion.shift, n);
+  }
+}
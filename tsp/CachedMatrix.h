@@ -0,0 +1,117 @@
+#ifndef TSP_CACHEDMATRIX_H_
+#define TSP_CACHEDMATRIX_H_
+
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "tsp/NeighborLists.h"
+#include "tsp/util.h"
+
+namespace tsp
+{
+  /**
+   * @brief [implements Matrix] caches distances of another matrix
+   *
+   * Up to dense_limit vertices all distances are stored in a lower
+   * triangular array, so every lookup is a single load. Above that only the
+   * distances to the k nearest neighbours of every vertex are stored (which
+   * covers most lookups of neighbour list based walkers) and the remaining
+   * ones are forwarded to the underlying matrix.
+   *
+   * Integral distances are stored as int32_t, others as float.
+   * @param Matrix [implements Matrix] ASSUMPTION: symmetric; has to
+   *   outlive the cache
+   */
+  template<typename Matrix> struct CachedMatrix
+  {
+    private:
+      typedef typename std::decay<decltype(
+        std::declval<const Matrix &>()(0, 0))>::type distance_type;
+
+    public:
+      typedef typename std::conditional<std::is_integral<distance_type>::value,
+              int32_t, float>::type value_type;
+
+      /** @brief default maximal size of a dense cache; 800MB of values */
+      static const size_t kDenseLimit = 20000;
+      /** @brief default number of cached neighbours in a sparse cache */
+      static const size_t kSparseNeighbors = 16;
+
+      /**
+       * @param _matrix [implements Matrix] cached matrix
+       * @param dense_limit maximal size of a matrix cached densely
+       * @param k neighbours per vertex cached sparsely
+       */
+      explicit CachedMatrix(const Matrix &_matrix,
+          size_t dense_limit = kDenseLimit, size_t k = kSparseNeighbors) :
+        matrix(_matrix), size_(_matrix.size1()),
+        dense_(size_ <= dense_limit)
+      {
+        assert(matrix.size1() == matrix.size2());
+        if (dense_)
+        {
+          values.resize(size_ * (size_ + 1) / 2);
+          for (size_t i = 0, c = 0; i < size_; ++i)
+            for (size_t j = 0; j <= i; ++j) values[c++] = matrix(i, j);
+        }
+        else
+        {
+          neighbor_lists(matrix, k, neighbors);
+          values.resize(neighbors.ids.size());
+          for (size_t i = 0; i < size_; ++i)
+            for (size_t j = 0; j < neighbors.k; ++j)
+              values[i * neighbors.k + j] = matrix(i, neighbors[i][j]);
+        }
+      }
+
+      value_type operator()(size_t i, size_t j) const
+      {
+        if (dense_)
+        {
+          if (i < j) std::swap(i, j);
+          return values[i * (i + 1) / 2 + j];
+        }
+        const uint32_t *row = neighbors[i];
+        for (size_t c = 0; c < neighbors.k; ++c)
+          if (row[c] == j) return values[i * neighbors.k + c];
+        return matrix(i, j);
+      }
+
+      size_t size1() const
+      {
+        return size_;
+      }
+      size_t size2() const
+      {
+        return size_;
+      }
+
+      /** @returns true iff all distances are cached */
+      bool dense() const
+      {
+        return dense_;
+      }
+
+      /** @brief cached matrix */
+      const Matrix &matrix;
+
+    private:
+      size_t size_;
+      bool dense_;
+      /** @brief lower triangle by rows if dense_, else along neighbors */
+      std::vector<value_type> values;
+      NeighborLists neighbors;
+  };
+
+  /** @brief see: tsp::matrix_points; points of the cached matrix */
+  template<typename Matrix>
+  const std::vector<Point> * matrix_points(const CachedMatrix<Matrix> &matrix)
+  {
+    return matrix_points(matrix.matrix);
+  }
+}  // namespace tsp
+
+#endif  // TSP_CACHEDMATRIX_H_
@@ -4,24 +4,37 @@
 #define TSP_CHRISTOFIDES_H_
 
 #include<boost/graph/adjacency_list.hpp>
+#include<boost/pending/disjoint_sets.hpp>
 
+#include<algorithm>
+#include<cassert>
 #include<cstdint>
 #include<cstddef>
 #include<cstdlib>
-#include<list>
-#include<memory>
+#include<deque>
+#include<limits>
+#include<utility>
 #include<iostream>
 #include<vector>
 #include<string>
 
 #include "blossom5/PerfectMatching.h"
 #include "blossom5/GEOM/GeomPerfectMatching.h"
+#include "tsp/NeighborLists.h"
+#include "tsp/Points.h"
+#include "tsp/SpaceFillingCurve.h"
 #include "tsp/util.h"
 
 namespace tsp {
 
+  /** @brief instances with points larger than this use mst_kruskal_neighbors */
+  static const size_t kChristofidesPrimLimit = 5000;
+
   /**
-   * @brief Creates minimum spanning tree using Prim's algorithm
+   * @brief Creates minimum spanning tree using Prim's algorithm in O(n^2).
+   *        Vertices outside of the tree are kept in compact arrays, from
+   *        which the closest one is swapped out, so every step is
+   *        a sequential scan followed by a vectorized minimum search.
    * @tparam GraphIn container that store distances between points
    *         that can be accessed by operator (x, y)
    * @tparam GraphOut graph that implements part of boost::graph
@@ -32,32 +45,29 @@ namespace tsp {
    */
   template<typename GraphIn, typename GraphOut>
   void mst_prim(const GraphIn &graph, GraphOut &out, size_t size) {
-    std::vector<int> edge(size);
-    std::vector<int> dist(size, INT_MAX);
-
-    int current = 0;
-    int min;
-    std::list<int> unused;
+    if (size < 2) return;
     // We are not adding 0, as it's starting point.
+    std::vector<size_t> unused(size - 1), edge(size - 1, 0);
+    std::vector<double> dist(size - 1,
+                             std::numeric_limits<double>::infinity());
     for (size_t i = 1; i < size; ++i) {
-        unused.push_back(i);
+      unused[i - 1] = i;
     }
-    auto next = unused.begin();
-    for (size_t i = 1; i < size; ++i) {
-      min = INT_MAX;
-      for (auto it = unused.begin(); it != unused.end(); ++it) {
-          if (dist[*it] > graph(current, *it)) {
-            dist[*it] = graph(current, *it);
-            edge[*it] = current;
-          }
-          if (dist[*it] < min) {
-            min = dist[*it];
-            next = it;
-          }
+    size_t current = 0;
+    for (size_t left = size - 1; left; --left) {
+      for (size_t i = 0; i < left; ++i) {
+        double d = graph(current, unused[i]);
+        if (d < dist[i]) {
+          dist[i] = d;
+          edge[i] = current;
+        }
       }
-      boost::add_edge(*next, edge[*next], out);
-      current = *next;
-      unused.erase(next);
+      size_t next = argmin(&dist[0], left);
+      current = unused[next];
+      boost::add_edge(current, edge[next], out);
+      unused[next] = unused[left - 1];
+      dist[next] = dist[left - 1];
+      edge[next] = edge[left - 1];
     }
 
 #ifdef DEBUG_CHRIST
@@ -72,6 +82,279 @@ namespace tsp {
   }
 
 
+  /**
+   * @brief Creates spanning tree of points using Kruskal's algorithm
+   *        on the graph of k nearest neighbours in O(n k log(n k)).
+   *        k is doubled until the graph is connected. The tree is
+   *        minimum whenever every edge of the minimum spanning tree
+   *        joins one of the k nearest neighbours of its ends, which
+   *        for geometric instances is the case with rare exceptions.
+   * @tparam GraphIn container that store distances between points
+   *         that can be accessed by operator (x, y)
+   * @tparam GraphOut graph that implements part of boost::graph
+   *         interface (add_edge)
+   * @param graph container of distances in graph
+   * @param out graph to store result tree
+   * @param points coordinates of graph vertices, see: tsp::matrix_points
+   * @param k initial number of neighbours per vertex
+   */
+  template<typename GraphIn, typename GraphOut>
+  void mst_kruskal_neighbors(const GraphIn &graph, GraphOut &out,
+                             const std::vector<Point> &points,
+                             size_t k = 10) {
+    struct Edge {
+      double d;
+      uint32_t a, b;
+      bool operator<(const Edge &e) const {
+        return d != e.d ? d < e.d : a != e.a ? a < e.a : b < e.b;
+      }
+      bool operator==(const Edge &e) const {
+        return a == e.a && b == e.b;
+      }
+    };
+    size_t n = points.size();
+    if (n < 2) return;
+    std::vector<Edge> edges, tree;
+    std::vector<size_t> rank(n), parent(n);
+    NeighborLists neighbors;
+    for (;; k *= 2) {
+      neighbor_lists_grid(points, k, neighbors);
+      edges.clear();
+      for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < neighbors.k; ++j) {
+          uint32_t a = i, b = neighbors[i][j];
+          if (a > b) std::swap(a, b);
+          edges.push_back(Edge{static_cast<double>(graph(a, b)), a, b});
+        }
+      }
+      std::sort(edges.begin(), edges.end());
+      edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+      boost::disjoint_sets<size_t*, size_t*> dsu(&rank[0], &parent[0]);
+      for (size_t v = 0; v < n; ++v) {
+        dsu.make_set(v);
+      }
+      tree.clear();
+      for (const Edge &e : edges) {
+        if (dsu.find_set(e.a) != dsu.find_set(e.b)) {
+          dsu.link(dsu.find_set(e.a), dsu.find_set(e.b));
+          tree.push_back(e);
+        }
+      }
+      if (tree.size() == n - 1 || neighbors.k == n - 1) break;
+    }
+    for (const Edge &e : tree) {
+      boost::add_edge(e.a, e.b, out);
+    }
+  }
+
+
+  /** @brief matching algorithm */
+  enum MatchingImplEnum {
+    /**
+     * non-geometric version: all pairs of odd vertices are matching
+     * candidates, exact
+     */
+    kMatchingDense,
+    /**
+     * non-geometric version: only pairs of k nearest odd neighbours and
+     * pairs (2i, 2i + 1), which guarantee that a perfect matching exists,
+     * are candidates
+     */
+    kMatchingSparse,
+    /**
+     * used instead of Blossom V also for the geometric version:
+     * greedy_matching, near-linear for graphs backed by points
+     */
+    kMatchingGreedy
+  };
+
+
+  /** @brief [implements Matrix] distances between chosen vertices */
+  template<typename Graph> struct VertexSubset {
+    VertexSubset(const Graph &_graph, const std::vector<int> &_ids) :
+      graph(_graph), ids(_ids) {}
+    const Graph &graph;
+    const std::vector<int> &ids;
+
+    double operator()(size_t i, size_t j) const {
+      return graph(ids[i], ids[j]);
+    }
+    size_t size1() const {
+      return ids.size();
+    }
+    size_t size2() const {
+      return ids.size();
+    }
+  };
+
+
+  /**
+   * @brief Finds k nearest neighbours among given vertices, on the grid
+   *        for graphs backed by points (see: tsp::matrix_points),
+   *        by scanning all pairs otherwise.
+   * @param graph container of distances in graph
+   * @param ids chosen vertices
+   * @param k number of neighbours per vertex
+   * @param lists lists to store neighbours (indices of ids) in
+   */
+  template<typename GraphIn>
+  void subset_neighbor_lists(const GraphIn &graph, const std::vector<int> &ids,
+                             size_t k, NeighborLists &lists) {
+    const std::vector<Point> *graph_points = matrix_points(graph);
+    if (graph_points) {
+      std::vector<Point> subset(ids.size());
+      for (size_t i = 0; i < ids.size(); ++i) {
+        subset[i] = (*graph_points)[ids[i]];
+      }
+      neighbor_lists_grid(subset, k, lists);
+    } else {
+      neighbor_lists_scan(VertexSubset<GraphIn>(graph, ids), k, lists);
+    }
+  }
+
+
+  /**
+   * @brief Collects candidate edges of the sparse matching: pairs of
+   *        k nearest neighbours among given vertices, and (2i, 2i + 1).
+   * @param graph container of distances in graph
+   * @param ids vertices to be matched
+   * @param k number of neighbours per vertex
+   * @param edges vector to store edges between indices of ids in
+   */
+  template<typename GraphIn>
+  void sparse_matching_edges(const GraphIn &graph, const std::vector<int> &ids,
+                             size_t k,
+                             std::vector<std::pair<int, int> > &edges) {
+    NeighborLists lists;
+    subset_neighbor_lists(graph, ids, k, lists);
+    edges.clear();
+    for (size_t i = 0; i < lists.size(); ++i) {
+      for (size_t j = 0; j < lists.k; ++j) {
+        int a = i, b = lists[i][j];
+        edges.push_back(std::make_pair(std::min(a, b), std::max(a, b)));
+      }
+    }
+    for (size_t i = 0; i + 1 < ids.size(); i += 2) {
+      edges.push_back(std::make_pair(i, i + 1));
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+  }
+
+
+  /**
+   * @brief Finds a cheap perfect matching without Blossom V:
+   *        candidate pairs of k nearest neighbours are matched greedily
+   *        by increasing weight, the remaining vertices are paired in
+   *        Hilbert curve order (in the given order if the graph is not
+   *        backed by points), and then pairs (a, b), (c, d) with c
+   *        a neighbour of a are replaced by (a, c), (b, d) while it
+   *        improves the matching. O(V k log(V k)) apart from the
+   *        improvement phase, which is fast in practice.
+   * @param graph container of distances in graph
+   * @param ids vertices to be matched, even number of them
+   * @param k number of neighbours per vertex
+   * @param mate vector to store the matching in: ids[i] is matched
+   *        with ids[mate[i]]
+   */
+  template<typename GraphIn>
+  void greedy_matching(const GraphIn &graph, const std::vector<int> &ids,
+                       size_t k, std::vector<int> &mate) {
+    struct Edge {
+      double d;
+      int a, b;
+      bool operator<(const Edge &e) const {
+        return d != e.d ? d < e.d : a != e.a ? a < e.a : b < e.b;
+      }
+    };
+    size_t n = ids.size();
+    assert(n % 2 == 0);
+    auto weight = [&](int a, int b) -> double {
+      return graph(ids[a], ids[b]);
+    };
+    mate.assign(n, -1);
+    NeighborLists lists;
+    subset_neighbor_lists(graph, ids, k, lists);
+
+    // greedy over candidate pairs
+    std::vector<Edge> edges;
+    for (size_t i = 0; i < lists.size(); ++i) {
+      for (size_t j = 0; j < lists.k; ++j) {
+        int a = i, b = lists[i][j];
+        if (a < b) {
+          edges.push_back(Edge{weight(a, b), a, b});
+        }
+      }
+    }
+    std::sort(edges.begin(), edges.end());
+    for (const Edge &e : edges) {
+      if (mate[e.a] < 0 && mate[e.b] < 0) {
+        mate[e.a] = e.b;
+        mate[e.b] = e.a;
+      }
+    }
+
+    // leftovers
+    std::vector<int> left;
+    for (size_t i = 0; i < n; ++i) {
+      if (mate[i] < 0) {
+        left.push_back(i);
+      }
+    }
+    const std::vector<Point> *graph_points = matrix_points(graph);
+    if (graph_points) {
+      std::vector<Point> subset(left.size());
+      for (size_t i = 0; i < left.size(); ++i) {
+        subset[i] = (*graph_points)[ids[left[i]]];
+      }
+      std::vector<int> order;
+      hilbert_sort(subset, order);
+      for (int &i : order) {
+        i = left[i];
+      }
+      left.swap(order);
+    }
+    for (size_t i = 0; i + 1 < left.size(); i += 2) {
+      mate[left[i]] = left[i + 1];
+      mate[left[i + 1]] = left[i];
+    }
+
+    // 2-opt improvement
+    std::deque<int> queue;
+    std::vector<bool> queued(n, true);
+    for (size_t i = 0; i < n; ++i) {
+      queue.push_back(i);
+    }
+    while (!queue.empty()) {
+      int a = queue.front();
+      queue.pop_front();
+      queued[a] = false;
+      int b = mate[a];
+      for (size_t j = 0; j < lists.k; ++j) {
+        int c = lists[a][j], d = mate[c];
+        if (c == b) {
+          continue;
+        }
+        if (weight(a, c) + weight(b, d) <
+            weight(a, b) + weight(c, d) - 1e-9) {
+          mate[a] = c;
+          mate[c] = a;
+          mate[b] = d;
+          mate[d] = b;
+          for (int v : {a, b, c, d}) {
+            if (!queued[v]) {
+              queued[v] = true;
+              queue.push_back(v);
+            }
+          }
+          break;
+        }
+      }
+    }
+  }
+
+
   /**
    * @brief Creates minimum weight perfect matching between odd
    *        vertices to make them even. It uses Blossom V
@@ -90,10 +373,18 @@ namespace tsp {
    *        types are: CEIL_2D, EUC2_D, ATT
    * @param points is an pointer to instance of Points that
    *        holds graph points coordinates.
+   * @param matching matching algorithm; kMatchingSparse gives a matching
+   *        minimum among the candidate edges only, in O(V k) memory
+   *        instead of O(V^2); kMatchingGreedy gives no guarantee, but
+   *        makes the whole heuristic near-linear for geometric graphs
+   * @param neighbors number of neighbours per vertex for kMatchingSparse
+   *        and kMatchingGreedy
    */
   template<typename GraphIn, typename GraphOut, typename Points = std::vector<Point> >
   void even_odd_vertices(const GraphIn &graph, GraphOut &out,
-                         std::string ewt = "", Points* points = nullptr) {
+                         std::string ewt = "", Points* points = nullptr,
+                         MatchingImplEnum matching = kMatchingDense,
+                         size_t neighbors = 10) {
     std::vector<int> oddV;
     for (size_t v = 0; v < graph.size1(); ++v) {
       if (boost::out_degree(v, out) % 2) {
@@ -107,7 +398,14 @@ namespace tsp {
     options.verbose = true;
 #endif
 
-    if ((ewt == "CEIL_2D" || ewt == "EUC_2D" || ewt == "ATT") &&
+    if (matching == kMatchingGreedy) {
+        std::vector<int> mate;
+        greedy_matching(graph, oddV, neighbors, mate);
+        for (size_t i = 0; i < oddV.size(); ++i) {
+          if (mate[i] > int(i))
+            boost::add_edge(oddV[i], oddV[mate[i]], out);
+        }
+    } else if ((ewt == "CEIL_2D" || ewt == "EUC_2D" || ewt == "ATT") &&
           points != nullptr) {
         GeomPerfectMatching gpm(oddV.size(), 2);
         gpm.options = options;
@@ -140,6 +438,21 @@ namespace tsp {
           if (m > oddV[i])
             boost::add_edge(oddV[i], m, out);
         }
+    } else if (matching == kMatchingSparse) {
+        std::vector<std::pair<int, int> > edges;
+        sparse_matching_edges(graph, oddV, neighbors, edges);
+        PerfectMatching pm(oddV.size(), edges.size());
+        pm.options = options;
+        for (const auto &e : edges) {
+          pm.AddEdge(e.first, e.second,
+                     graph(oddV[e.first], oddV[e.second]));
+        }
+        pm.Solve();
+        for (size_t i = 0; i < oddV.size(); ++i) {
+          int m = oddV[pm.GetMatch(i)];
+          if (m > oddV[i])
+            boost::add_edge(oddV[i], m, out);
+        }
     } else {
         PerfectMatching pm(oddV.size(), oddV.size() * oddV.size() / 2);
         pm.options = options;
@@ -168,98 +481,109 @@ namespace tsp {
   }
 
 
-  /* @brief ArrayList for efficient finding of eulerian cycle. */
-  struct CycleList {
-    /* @brief number of vertex in graph */
-    int vertex;
-    /* @brief next vertex in cycle */
-    CycleList* next;
+  /**
+   * @brief Undirected multigraph in compressed sparse row form.
+   *        Every edge is stored twice, once at each of its ends.
+   */
+  struct EulerGraph {
+    /**
+     * @brief builds the graph from an edge list in O(V + E)
+     * @param vertices number of vertices
+     * @param edges list of edges, loops are not allowed
+     */
+    void assign(size_t vertices,
+                const std::vector<std::pair<uint32_t, uint32_t> > &edges) {
+      start.assign(vertices + 1, 0);
+      for (const auto &e : edges) {
+        ++start[e.first + 1];
+        ++start[e.second + 1];
+      }
+      for (size_t v = 0; v < vertices; ++v) {
+        start[v + 1] += start[v];
+      }
+      adj.resize(2 * edges.size());
+      edge_id.resize(2 * edges.size());
+      std::vector<uint32_t> fill(start.begin(), start.end() - 1);
+      for (size_t i = 0; i < edges.size(); ++i) {
+        adj[fill[edges[i].first]] = edges[i].second;
+        edge_id[fill[edges[i].first]++] = i;
+        adj[fill[edges[i].second]] = edges[i].first;
+        edge_id[fill[edges[i].second]++] = i;
+      }
+    }
+
+    size_t num_vertices() const {
+      return start.size() - 1;
+    }
+
+    size_t num_edges() const {
+      return adj.size() / 2;
+    }
+
+    /** @brief edges of vertex v are [start[v], start[v + 1]) */
+    std::vector<uint32_t> start;
+    /** @brief other end of the edge */
+    std::vector<uint32_t> adj;
+    /** @brief index of the edge in the edge list */
+    std::vector<uint32_t> edge_id;
   };
 
 
   /**
-   * @brief Finds a cycle in given graph that starts from the given vertex
-   *        and removes it from graph.
+   * @brief Copies edges of a graph into EulerGraph.
    * @tparam Graph graph that implements part of boost::graph
-   *         interface (out_degree, out_edges, target, remove_edge).
-   * @param graph source graph that will get modified
-   * @param cycle CycleList array to store the found cycle
-   * @param added boolean array indicating if vertex was added to toCheck
-   * @param toCheck list of vertices that could be not used up
-   * @param start number of vertex to start looking for cycle
+   *         interface (num_vertices, edges, source, target)
+   * @param graph source graph
+   * @param out graph to store copied edges
    */
   template<typename Graph>
-  int find_cycle(Graph* graph, CycleList cycle[], std::vector<bool> &added,
-                 std::list<CycleList*> &toCheck, int start) {
-#ifdef DEBUG_CHRIST
-    cout << "Starting from: " << start << endl;
-#endif
-    int size = 0;
-    int current = start;
-    typename boost::graph_traits<Graph>::out_edge_iterator edge;
-    while (out_degree(current, *graph)) {
-      edge = boost::out_edges(current, *graph).first;
-      current = boost::target(*edge, *graph);
-      boost::remove_edge(edge, *graph);
-      cycle->vertex = current;
-      cycle->next = cycle + 1;
-      if (!added[current]) {
-        added[current] = true;
-        toCheck.push_back(cycle);
-      }
-      cycle = cycle + 1;
-      ++size;
-    }
-#ifdef DEBUG_CHRIST
-    std::cout << "Found cycle size: " << size << std::endl;
-    if (size == 0) {
-      exit(0);
+  void euler_graph(const Graph &graph, EulerGraph &out) {
+    std::vector<std::pair<uint32_t, uint32_t> > edges;
+    typename boost::graph_traits<Graph>::edge_iterator edgea, edgeb;
+    for (boost::tie(edgea, edgeb) = boost::edges(graph); edgea != edgeb;
+         ++edgea) {
+      edges.push_back(std::make_pair(boost::source(*edgea, graph),
+                                     boost::target(*edgea, graph)));
     }
-#endif
-    return size;
+    out.assign(boost::num_vertices(graph), edges);
   }
 
 
   /**
-   * @brief Finds eulerian cycle in given graph, saves it to
-   *        cycle and deletes all edges from graph.
-   * @tparam Graph graph that implements part of boost::graph
-   *         interface (num_edges, num_vertices, out_degree)
-   * @param graph source graph that will be cleaned from edges
-   * @param cycle CycleList array to store the found eulerian cycle
+   * @brief Finds eulerian circuit of a connected graph with even degrees
+   *        using iterative Hierholzer's algorithm in O(V + E). Every vertex
+   *        keeps a cursor to its first possibly unused edge and used edges
+   *        are marked in a bitmap, so the graph is not modified.
+   * @param graph source graph
+   * @param start vertex to start the circuit from
+   * @param circuit vector to store the vertices of the circuit in;
+   *        it has num_edges() + 1 elements, the first one equal to the last
    */
-  template<typename Graph>
-  void find_eulerian_cycle(Graph* graph, CycleList cycle[]) {
-    int to_do = boost::num_edges(*graph) + 1;
-    std::vector<bool> added(boost::num_vertices(*graph), false);
-    std::list<CycleList*> toCheck;
-    int done_overall = 1, done_this_iter = 0;
-    int start = 0;
-    CycleList* ver;
-    CycleList* change = cycle;
-    change->vertex = start;
-    while (to_do != done_overall) {
-      done_this_iter = find_cycle<Graph>(graph, cycle + done_overall,
-                                         added, toCheck,
-                                         change->vertex);
-      (cycle + done_overall + done_this_iter - 1)->next = change->next;
-      change->next = cycle + done_overall;
-      done_overall += done_this_iter;
-      while (toCheck.size()) {
-        ver = toCheck.front();
-        toCheck.pop_front();
-        if (boost::out_degree(ver->vertex, *graph)) {
-          change = ver;
-          break;
-        }
+  inline void find_eulerian_circuit(const EulerGraph &graph, uint32_t start,
+                                    std::vector<uint32_t> &circuit) {
+    std::vector<uint32_t> next(graph.start.begin(), graph.start.end() - 1);
+    std::vector<bool> used(graph.num_edges(), false);
+    std::vector<uint32_t> stack(1, start);
+    circuit.clear();
+    circuit.reserve(graph.num_edges() + 1);
+    while (!stack.empty()) {
+      uint32_t v = stack.back();
+      uint32_t &e = next[v];
+      while (e < graph.start[v + 1] && used[graph.edge_id[e]]) {
+        ++e;
+      }
+      if (e == graph.start[v + 1]) {
+        circuit.push_back(v);
+        stack.pop_back();
+      } else {
+        used[graph.edge_id[e]] = true;
+        stack.push_back(graph.adj[e++]);
       }
     }
 #ifdef DEBUG_CHRIST
     std::cout << "Eulerian cycle" << std::endl;
-    CycleList* current = cycle;
-    for (int i = 0; i < to_do; ++i) {
-      std::cout << current->vertex << " ";
-      current = current->next;
+    for (uint32_t v : circuit) {
+      std::cout << v << " ";
     }
     std::cout << std::endl;
 #endif
@@ -271,27 +595,24 @@ namespace tsp {
    *        by shortcutting.
    * @tparam Cycle cycle with operator[] as access method
    * @param eulerian_cycle source eulerian cycle from which
-   *        hamiltonian one is created
+   *        hamiltonian one is created, see: find_eulerian_circuit
    * @param out cycle to store resulting cycle within
-   * @param edge_num number of edges in eulerian cycle
    * @param vert_num number of vertices in graph
    */
   template<typename Cycle>
-  void find_hamiltonian_cycle(CycleList eulerian_cycle[], Cycle* out,
-                              int edge_num, int vert_num) {
+  void find_hamiltonian_cycle(const std::vector<uint32_t> &eulerian_cycle,
+                              Cycle* out, size_t vert_num) {
     std::vector<bool> used(vert_num, false);
-    CycleList* current = &eulerian_cycle[0];
-    int n = 0;
-    for (int i = 0; i <= edge_num; ++i) {
-      if (!used[current->vertex]) {
-        used[current->vertex] = true;
-        (*out)[n++] = current->vertex;
+    size_t n = 0;
+    for (uint32_t v : eulerian_cycle) {
+      if (!used[v]) {
+        used[v] = true;
+        (*out)[n++] = v;
       }
-      current = current->next;
     }
 #ifdef DEBUG_CHRIST
     std::cout << "Hamiltonian cycle:" << std::endl;
-    for (int i = 0; i < vert_num; ++i) {
+    for (size_t i = 0; i < vert_num; ++i) {
       std::cout << (*out)[i] << " ";
     }
     std::cout << std::endl;
@@ -299,11 +620,58 @@ namespace tsp {
   }
 
 
+  /**
+   * @brief First three steps of Christofides heuristic: spanning tree,
+   *        matching of odd vertices and eulerian circuit of their union,
+   *        see: christofides
+   * @tparam Graph container that store distances between points
+   *         that can be accessed by operator (x, y)
+   * @tparam Points used only with geometric version, it's type
+   *         of points container
+   * @param graph container of distances in graph
+   * @param circuit vector to store the eulerian circuit in,
+   *        see: find_eulerian_circuit
+   * @param size size of problem
+   * @param ewt see: christofides
+   * @param points see: christofides
+   * @param matching see: even_odd_vertices
+   * @param neighbors see: even_odd_vertices
+   */
+  template<typename Graph, typename Points = std::vector<Point> >
+  void christofides_circuit(const Graph &graph,
+                            std::vector<uint32_t> &circuit, size_t size,
+                            std::string ewt = "", Points* points = nullptr,
+                            MatchingImplEnum matching = kMatchingDense,
+                            size_t neighbors = 10) {
+    typedef boost::adjacency_list<boost::vecS, boost::vecS,
+        boost::undirectedS> AdjList;
+    circuit.clear();
+    if (!size) return;
+    AdjList _graph(size);
+    // 1. Build minimum spanning tree.
+    const std::vector<Point> *graph_points = matrix_points(graph);
+    if (graph_points && size > kChristofidesPrimLimit)
+      mst_kruskal_neighbors<Graph, AdjList>(graph, _graph, *graph_points);
+    else
+      mst_prim<Graph, AdjList>(graph, _graph, size);
+    // 2. Create minimum weight perfect mathing over odd vertices in tree.
+    even_odd_vertices<Graph, AdjList, Points>(graph, _graph, ewt, points,
+                                              matching, neighbors);
+    EulerGraph euler;
+    euler_graph(_graph, euler);
+    // 3. Find eulerian cycle in created multigraph.
+    find_eulerian_circuit(euler, 0, circuit);
+  }
+
+
   /**
    * @brief Implementation of Christofides heuristic for
    *        finding 1.5-approximation for instance of
    *        Symmetric Traveling Salesman Problem.
    *        Description of algorithm can be found on Wikipedia.
+   *        For graphs backed by more than kChristofidesPrimLimit points
+   *        (see: tsp::matrix_points) the spanning tree is built
+   *        by mst_kruskal_neighbors instead of mst_prim.
    * @tparam Graph container that store distances between points
    *         that can be accessed by operator (x, y)
    * @tparam Cycle cycle with operator[] as access method
@@ -317,24 +685,20 @@ namespace tsp {
    *        geometric version.
    * @param points is an pointer to instance of Points that
    *        holds graph points coordinates.
+   * @param matching see: even_odd_vertices
+   * @param neighbors see: even_odd_vertices
    */
   template<typename Graph, typename Cycle, typename Points = std::vector<Point> >
   void christofides(const Graph &graph, Cycle &cycle, size_t size,
-                    std::string ewt = "", Points* points = nullptr) {
-    typedef boost::adjacency_list<boost::vecS, boost::vecS,
-        boost::undirectedS> AdjList;
-    AdjList _graph(size);
-    // 1. Build minimum spanning tree.
-    mst_prim<Graph, AdjList>(graph, _graph, size);
-    // 2. Create minimum weight perfect mathing over odd vertices in tree.
-    even_odd_vertices<Graph, AdjList, Points>(graph, _graph, ewt, points);
-    int edge_num = num_edges(_graph);
-    std::unique_ptr<CycleList[]> eulerian_cycle(new CycleList[edge_num + 1]);
-    // 3. Find eulerian cycle in created multigraph.
-    find_eulerian_cycle<AdjList>(&_graph, eulerian_cycle.get());
+                    std::string ewt = "", Points* points = nullptr,
+                    MatchingImplEnum matching = kMatchingDense,
+                    size_t neighbors = 10) {
+    std::vector<uint32_t> eulerian_cycle;
+    // 1-3. Find eulerian cycle of spanning tree and matching.
+    christofides_circuit<Graph, Points>(graph, eulerian_cycle, size, ewt,
+                                        points, matching, neighbors);
     // 4. Create hamiltionian cycle from found eulerian cycle.
-    find_hamiltonian_cycle<Cycle>(eulerian_cycle.get(), &cycle, edge_num,
-                                  size);
+    find_hamiltonian_cycle<Cycle>(eulerian_cycle, &cycle, size);
   }
 }
 
@@ -57,6 +57,12 @@ namespace tsp
      */
     std::vector<Point> pos;
   };
+
+  /** @brief see: tsp::matrix_points */
+  inline const std::vector<Point> * matrix_points(const EuclidMatrix &matrix)
+  {
+    return &matrix.pos;
+  }
 }  // namespace tsp
 
 #endif  // TSP_EUCLIDMATRIX_H_
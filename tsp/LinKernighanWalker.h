@@ -0,0 +1,195 @@
+#ifndef TSP_LINKERNIGHANWALKER_H_
+#define TSP_LINKERNIGHANWALKER_H_
+
+// http://en.wikipedia.org/wiki/Lin%E2%80%93Kernighan_heuristic
+
+#include <cassert>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "rsarray/RSArray.h"
+#include "tsp/NeighborLists.h"
+#include "tsp/util.h"
+
+namespace tsp
+{
+  /**
+   * @brief [implements Walker] variable-depth Lin-Kernighan strategy
+   *
+   * A step is a chain of up to max_depth 2-opt moves sharing the vertex t1:
+   * edge (t1,t2) is broken, (t2,t3) is added for a candidate neighbour t3
+   * of t2, (t3,t4) is broken and the path t2..t4 is reversed, so t4 becomes
+   * the new t2. The chain is probed on the tour itself and rolled back;
+   * the prefix with the best gain is replayed by make_step.
+   *
+   * The tour is kept in rsarray::RSArray, so every reversal and position
+   * lookup costs O(sqrt(n)) amortized, instead of O(n) on std::vector.
+   * @param Matrix [implements Matrix] ASSUMPTION: symmetric
+   */
+  template<typename Matrix> struct LinKernighanWalker
+  {
+      /**
+       * @param _matrix [implements Matrix] problem definition (distance matrix)
+       * @param _neighbors candidate sets, see: neighbor_lists
+       * @param _cycle [implements Cycle] initial solution
+       * @param _max_depth maximal number of 2-opt moves in a step
+       */
+      template<typename Cycle>
+      LinKernighanWalker(const Matrix &_matrix,
+          const NeighborLists &_neighbors, const Cycle &_cycle,
+          size_t _max_depth = 6) :
+        matrix(_matrix), neighbors(_neighbors), max_depth(_max_depth),
+        forward(true), depth(0), cycle(_cycle)
+      {
+        assert(matrix.size1() == matrix.size2() &&
+               matrix.size1() == _cycle.size() &&
+               neighbors.size() == _cycle.size() && max_depth);
+        current_fitness_ = next_fitness_ = fitness(matrix, tour());
+      }
+
+    private:
+      /** @brief reversal of [begin,end), turning the orientation if turn */
+      struct Flip
+      {
+        size_t begin, end;
+        bool turn;
+      };
+
+      const Matrix &matrix;
+      const NeighborLists &neighbors;
+      size_t max_depth;
+      double current_fitness_, next_fitness_;
+      /** @brief whether the tour is read in the order of cycle */
+      bool forward;
+      /** @brief moves probed by the last prepare_step */
+      std::vector<Flip> chain;
+      /** @brief edges added by the probed moves */
+      std::vector<std::pair<size_t, size_t> > added;
+      /** @brief number of leading moves of chain making the step */
+      size_t depth;
+
+      /** @brief read-only access, keeps the position index of cycle valid */
+      const rsarray::RSArray<size_t> & tour() const
+      {
+        return cycle;
+      }
+
+      size_t succ(size_t v)
+      {
+        size_t n = cycle.size(), p = cycle.position(v);
+        return tour()[forward ? (p + 1 < n ? p + 1 : 0) : (p ? p - 1 : n - 1)];
+      }
+
+      size_t pred(size_t v)
+      {
+        size_t n = cycle.size(), p = cycle.position(v);
+        return tour()[forward ? (p ? p - 1 : n - 1) : (p + 1 < n ? p + 1 : 0)];
+      }
+
+      void apply(const Flip &f)
+      {
+        cycle.reverse(f.begin, f.end);
+        if (f.turn) forward = !forward;
+      }
+
+      /**
+       * @brief reverses the path a..b of the tour
+       * A path wrapping around the array is reversed through its complement
+       * followed by a change of orientation.
+       */
+      Flip reverse_path(size_t a, size_t b)
+      {
+        size_t pa = cycle.position(a), pb = cycle.position(b);
+        size_t i = forward ? pa : pb, j = forward ? pb : pa;
+        Flip f;
+        if (i <= j) f.begin = i, f.end = j + 1, f.turn = false;
+        else f.begin = j + 1, f.end = i, f.turn = true;
+        apply(f);
+        return f;
+      }
+
+      bool was_added(size_t a, size_t b) const
+      {
+        for (const auto & e : added)
+          if ((e.first == a && e.second == b) ||
+              (e.first == b && e.second == a)) return true;
+        return false;
+      }
+
+    public:
+      rsarray::RSArray<size_t> cycle;
+
+      double current_fitness()
+      {
+        return current_fitness_;
+      }
+      double next_fitness()
+      {
+        return next_fitness_;
+      }
+
+      /**
+       * probes a chain from a random t1 in a random orientation; at every
+       * level the candidate maximizing d(t3,t4) - d(t2,t3) with positive
+       * partial gain is taken. If no prefix improves, the best one is
+       * proposed anyway (useful for annealing); for an empty chain the step
+       * is empty.
+       */
+      template<typename Random>
+      void prepare_step(double progress, Random &random)
+      {
+        size_t n = cycle.size();
+        chain.clear();
+        added.clear();
+        depth = 0;
+        next_fitness_ = current_fitness_;
+        if (n < 5) return;
+        forward = random() & 1;
+        size_t t1 = tour()[random() % n], t2 = succ(t1);
+        double g = matrix(t1, t2);
+        double best_gain = -std::numeric_limits<double>::infinity();
+        while (chain.size() < max_depth)
+        {
+          size_t t3 = n, t4 = n, t2n = succ(t2);
+          double best = -std::numeric_limits<double>::infinity();
+          for (size_t k = 0; k < neighbors.k; ++k)
+          {
+            size_t c = neighbors[t2][k];
+            if (c == t1 || c == t2n || g - matrix(t2, c) <= 0) continue;
+            size_t d = pred(c);
+            if (was_added(c, d)) continue;
+            double v = matrix(c, d) - matrix(t2, c);
+            if (v > best)
+            {
+              best = v;
+              t3 = c;
+              t4 = d;
+            }
+          }
+          if (t3 == n) break;
+          chain.push_back(reverse_path(t2, t4));
+          added.push_back(std::make_pair(t2, t3));
+          g += best;
+          double gain = g - matrix(t4, t1);
+          if (gain > best_gain)
+          {
+            best_gain = gain;
+            depth = chain.size();
+          }
+          t2 = t4;
+        }
+        // reversals are involutions
+        for (size_t i = chain.size(); i--;) apply(chain[i]);
+        if (depth) next_fitness_ = current_fitness_ - best_gain;
+      }
+
+      void make_step()
+      {
+        for (size_t i = 0; i < depth; ++i) apply(chain[i]);
+        current_fitness_ = next_fitness_;
+      }
+  };
+}  // namespace tsp
+
+#endif  // TSP_LINKERNIGHANWALKER_H_
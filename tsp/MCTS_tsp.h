@@ -1,6 +1,8 @@
 #ifndef TSP_MCTS_TSP_H_
 #define TSP_MCTS_TSP_H_
 
+#include <cassert>
+#include <cstdint>
 #include <limits>
 #include <algorithm>
 #include <cmath>
@@ -9,11 +11,14 @@
 #include <functional>
 #include <utility>
 
+#include "mcts/TranspositionTable.h"
+
 namespace tsp
 {
   using mcts::Fitness;
 
-  /** @brief [implements mcts::State]
+  /** @brief [implements mcts::State, mcts::UndoState, mcts::HashState,
+   * mcts::WideningState]
    * TSP cycle building state for MCTS tree with accurate (exhaustive search)
    * estimates for small subtrees
    **/
@@ -22,6 +27,13 @@ namespace tsp
     public:
       typedef size_t Move;
 
+      /** @brief [implements mcts::UndoState::Undo] what apply overwrites */
+      struct Undo
+      {
+        size_t last_vertex;
+        Fitness cost;
+      };
+
     private:
       const Matrix& matrix_;
       const size_t exhaustive_limit_;
@@ -30,6 +42,12 @@ namespace tsp
       size_t first_vertex_;
       size_t last_vertex_;
       std::vector<bool> in_path_;
+      uint64_t hash_;
+
+      /** @brief Zobrist keys of a vertex in the path and of the last
+       * vertex, computed instead of stored */
+      static uint64_t path_key(size_t v) { return mcts::mix64(2 * v); }
+      static uint64_t last_key(size_t v) { return mcts::mix64(2 * v + 1); }
 
       struct MovesComparator
       {
@@ -39,31 +57,60 @@ namespace tsp
         MovesComparator(size_t last, const Matrix& matrix) : last_(last),
           matrix_(matrix) {}
 
+        /** @brief nearest first, ties broken by index */
         bool operator()(size_t v1, size_t v2)
-        { return matrix_(last_, v1) < matrix_(last_, v2); }
+        {
+          return matrix_(last_, v1) < matrix_(last_, v2) ||
+            (matrix_(last_, v1) == matrix_(last_, v2) && v1 < v2);
+        }
       };
 
-      template<typename Combine>
-      Fitness exhaustive_accumulate(Combine combine, Fitness initial)
+      /**
+       * @brief Held-Karp dynamic programming over subsets of the vertices
+       * left: the cheapest path from last through all of them back to
+       * first_vertex_, in O(2^k k^2) time and O(2^k k) memory for k
+       * vertices left
+       * @returns cost of the cheapest such path
+       **/
+      Fitness held_karp(size_t last, const std::vector<Move> &left) const
       {
-        auto left_vertices = moves_all();
-        // assertion: left_vertices vector is sorted in asceding order
-        Fitness accumulator = initial;
-        do
+        const size_t k = left.size();
+        assert(k && k <= kExhaustiveMax);
+        // reused by all states of the thread, as states are copied for
+        // every playout; table[mask * k + j] is the cheapest path from
+        // last through the vertices of mask ending at left[j]
+        static thread_local std::vector<Fitness> table, dist;
+        const size_t full = size_t(1) << k;
+        if (table.size() < full * k) table.resize(full * k);
+        dist.resize(k * k);
+        for (size_t i = 0; i < k; i++)
+          for (size_t j = 0; j < k; j++)
+            dist[i * k + j] = matrix_(left[i], left[j]);
+        for (size_t j = 0; j < k; j++)
+          table[(size_t(1) << j) * k + j] = matrix_(last, left[j]);
+
+        for (size_t mask = 1; mask < full; mask++)
         {
-          Fitness cost = cost_;
-          size_t last = last_vertex_;
-          for (auto v : left_vertices)
+          if (!(mask & (mask - 1))) continue;
+          Fitness *row = &table[mask * k];
+          for (size_t j = 0; j < k; j++)
           {
-            cost += matrix_(last, v);
-            last = v;
+            if (!(mask >> j & 1)) continue;
+            const size_t prev = mask ^ (size_t(1) << j);
+            const Fitness *prev_row = &table[prev * k];
+            Fitness best = std::numeric_limits<Fitness>::infinity();
+            for (size_t i = 0; i < k; i++)
+              if (prev >> i & 1)
+                best = std::min(best, prev_row[i] + dist[i * k + j]);
+            row[j] = best;
           }
-          cost += matrix_(last, first_vertex_);
-          accumulator = combine(accumulator, cost);
         }
-        while (std::next_permutation(left_vertices.begin(),
-              left_vertices.end()));
-        return accumulator;
+
+        Fitness best = std::numeric_limits<Fitness>::infinity();
+        const Fitness *row = &table[(full - 1) * k];
+        for (size_t j = 0; j < k; j++)
+          best = std::min(best, row[j] + matrix_(left[j], first_vertex_));
+        return best;
       }
 
       const std::vector<Move> moves_all() const
@@ -78,18 +125,23 @@ namespace tsp
       }
 
     public:
+      /** @brief maximal number of moves left exhaustive_search_min accepts;
+       * it uses 2^k k Fitness values (8 MB for 16) */
+      static const size_t kExhaustiveMax = 16;
+
       Fitness cost_;
 
       /** @brief Creates initial state for TSP instance
        * @param matrix a [tsp::Matrix] holding distances between vertices
        * @param moves_limit maximal number of moves to return by moves() call
-       * @param exhaustive_limit maximal number of moves left when
-       * extimate_playout is allowed to start exhaustive search
+       * @param exhaustive_limit estimate_playout finishes with exhaustive
+       * search once fewer moves than this are left, at most
+       * kExhaustiveMax + 1
        **/
       explicit TSPState(
           const Matrix& matrix,
           size_t moves_limit = std::numeric_limits<size_t>::max(),
-          size_t exhaustive_limit = 4) :
+          size_t exhaustive_limit = 8) :
         matrix_(matrix),
         exhaustive_limit_(exhaustive_limit),
         moves_limit_(moves_limit),
@@ -98,8 +150,10 @@ namespace tsp
         last_vertex_(first_vertex_),
         cost_(0)
       {
+        assert(exhaustive_limit_ <= kExhaustiveMax + 1);
         in_path_.resize(matrix.size1(), false);
         in_path_[first_vertex_] = true;
+        hash_ = path_key(first_vertex_) ^ last_key(first_vertex_);
       }
 
       /** @brief Determines whether state is terminal */
@@ -107,38 +161,59 @@ namespace tsp
 
       /** @brief Mutates state according to provided Move
        * @param move a Move to apply
+       * @returns token reverting the move, see: undo
        **/
-      void apply(const Move& move)
+      Undo apply(const Move& move)
       {
         assert(!is_terminal());
         assert(!in_path_[move]);
+        Undo undo = { last_vertex_, cost_ };
         in_path_[move] = true;
+        hash_ ^= last_key(last_vertex_) ^ last_key(move) ^ path_key(move);
         left_count_--;
         cost_ += matrix_(last_vertex_, move);
         last_vertex_ = move;
         if (is_terminal()) { cost_ += matrix_(last_vertex_, first_vertex_); }
+        return undo;
+      }
+
+      /** @brief Reverts the last move not reverted yet
+       * @param undo token returned by apply of that move
+       **/
+      void undo(const Undo& undo)
+      {
+        assert(in_path_[last_vertex_] && last_vertex_ != first_vertex_);
+        in_path_[last_vertex_] = false;
+        hash_ ^= last_key(last_vertex_) ^ path_key(last_vertex_) ^
+          last_key(undo.last_vertex);
+        left_count_++;
+        last_vertex_ = undo.last_vertex;
+        cost_ = undo.cost;
       }
 
-      /** @brief Estimates objective function for current state
+      /** @brief Estimates objective function for current state by a random
+       * completion of the cycle, leaves the state unchanged
        * @param random a random number generator compliant with C++11 random concept
        **/
       template<typename Random> Fitness estimate_playout(Random& random)
       {
-        if (!is_terminal())
+        if (is_terminal()) return cost_;
+        // reused by all states of the thread, see: held_karp
+        static thread_local std::vector<Move> left_moves;
+        left_moves.clear();
+        for (size_t i = 0; i < in_path_.size(); i++)
+          if (!in_path_[i]) left_moves.push_back(i);
+        std::shuffle(left_moves.begin(), left_moves.end(), random);
+        Fitness cost = cost_;
+        size_t last = last_vertex_;
+        while (!left_moves.empty() && left_moves.size() >= exhaustive_limit_)
         {
-          auto left_moves = moves_all();
-          std::shuffle(left_moves.begin(), left_moves.end(), random);
-          for (auto m : left_moves)
-          {
-            if (left_decisions() < exhaustive_limit_)
-            {
-              exhaustive_search_min();
-              break;
-            }
-            apply(m);
-          }
+          cost += matrix_(last, left_moves.back());
+          last = left_moves.back();
+          left_moves.pop_back();
         }
-        return cost_;
+        if (left_moves.empty()) return cost + matrix_(last, first_vertex_);
+        return cost + held_karp(last, left_moves);
       }
 
       /** @brief Enumerates moves allowed from current State
@@ -157,18 +232,28 @@ namespace tsp
         return ms;
       }
 
-      /** @brief Makes an exhaustive search and returns minimal estimate from
-       * estimates of all states reachable from current one by applying finite
-       * number of moves
-       * @returns estimate of objective function
+      /** @brief [mcts::WideningState] the nearest count of the moves(),
+       * nearest first; O(n log count)
+       **/
+      const std::vector<Move> moves(size_t count) const
+      {
+        assert(!is_terminal());
+        std::vector<Move> ms = moves_all();
+        count = std::min(count, std::min(ms.size(), moves_limit_));
+        std::partial_sort(ms.begin(), ms.begin() + count, ms.end(),
+            MovesComparator(last_vertex_, matrix_));
+        ms.resize(count);
+        return ms;
+      }
+
+      /** @brief Finds the cheapest completion of the cycle by exhaustive
+       * search (see: held_karp) and makes the state terminal with its cost;
+       * at most kExhaustiveMax moves may be left
        **/
       void exhaustive_search_min()
       {
         assert(!is_terminal());
-        Fitness best_cost = exhaustive_accumulate(
-              [](Fitness a, Fitness b) -> Fitness { return (a < b) ? a : b; },
-              std::numeric_limits<Fitness>::infinity());
-        cost_ = best_cost;
+        cost_ += held_karp(last_vertex_, moves_all());
         // we're not reproducing moves sequence but making state terminal
         left_count_ = 0;
         assert(is_terminal());
@@ -179,6 +264,26 @@ namespace tsp
        * @returns number of moves to terminal state
        **/
       size_t left_decisions() const { return left_count_; }
+
+      /** @brief [implements mcts::HashState] hash of the vertices in the
+       * path and the last one, which determine the rest of the game; the
+       * cost of the path so far may differ between equal states, see: cost
+       **/
+      uint64_t hash() const { return hash_; }
+
+      /** @brief hash() after apply(move) */
+      uint64_t hash(const Move& move) const
+      {
+        return hash_ ^ last_key(last_vertex_) ^ last_key(move) ^
+          path_key(move);
+      }
+
+      /** @brief cost_ after apply(move) */
+      Fitness cost(const Move& move) const
+      {
+        Fitness cost = cost_ + matrix_(last_vertex_, move);
+        return left_count_ == 1 ? cost + matrix_(move, first_vertex_) : cost;
+      }
   };
 }  // namespace tsp
 
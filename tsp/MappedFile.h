@@ -0,0 +1,209 @@
+#ifndef TSP_MAPPEDFILE_H_
+#define TSP_MAPPEDFILE_H_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+#include "./format.h"
+
+namespace tsp
+{
+  /** @brief read-only memory mapping of a whole file */
+  struct MappedFile
+  {
+    /** @throws std::runtime_error if the file cannot be mapped */
+    explicit MappedFile(const std::string &path) : data_(nullptr), size_(0)
+    {
+      int fd = open(path.c_str(), O_RDONLY);
+      if (fd < 0) throw std::runtime_error(format("cannot open %", path));
+      struct stat st;
+      if (fstat(fd, &st) < 0)
+      {
+        close(fd);
+        throw std::runtime_error(format("cannot stat %", path));
+      }
+      size_ = st.st_size;
+      if (size_)
+      {
+        void *p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED)
+        {
+          close(fd);
+          throw std::runtime_error(format("cannot map %", path));
+        }
+        madvise(p, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char *>(p);
+      }
+      close(fd);
+    }
+
+    ~MappedFile()
+    {
+      if (size_) munmap(const_cast<char *>(data_), size_);
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile & operator=(const MappedFile &) = delete;
+
+    const char * begin() const
+    {
+      return data_;
+    }
+    const char * end() const
+    {
+      return data_ + size_;
+    }
+    size_t size() const
+    {
+      return size_;
+    }
+
+    private:
+      const char *data_;
+      size_t size_;
+  };
+
+  /**
+   * @brief tokenizer of text in memory (e.g. MappedFile); numbers are
+   * parsed in place, without copying or a terminating '\0'
+   */
+  struct TextScanner
+  {
+    TextScanner(const char *_begin, const char *_end) : p(_begin), end(_end) {}
+
+    /** @brief skips whitespace; @return whether anything is left */
+    bool skip_space()
+    {
+      while (p != end && is_space(*p)) ++p;
+      return p != end;
+    }
+
+    /** @return next word delimited by whitespace, empty at the end */
+    std::string word()
+    {
+      skip_space();
+      const char *b = p;
+      while (p != end && !is_space(*p)) ++p;
+      return std::string(b, p);
+    }
+
+    /** @return rest of the current line, without surrounding whitespace */
+    std::string line()
+    {
+      while (p != end && *p != '\n' && is_space(*p)) ++p;
+      const char *b = p;
+      while (p != end && *p != '\n') ++p;
+      const char *e = p;
+      while (e != b && is_space(e[-1])) --e;
+      if (p != end) ++p;
+      return std::string(b, e);
+    }
+
+    /** @return false (and leaves x) if the next word is not an integer */
+    bool read(int &x)
+    {
+      skip_space();
+      const char *q = p;
+      bool negative = q != end && *q == '-';
+      if (q != end && (*q == '-' || *q == '+')) ++q;
+      if (q == end || !is_digit(*q)) return false;
+      int64_t v = 0;
+      for (; q != end && is_digit(*q); ++q) v = 10 * v + (*q - '0');
+      if (q != end && !is_space(*q)) return false;
+      x = negative ? -v : v;
+      p = q;
+      return true;
+    }
+
+    /**
+     * @brief parses a decimal number with optional fraction and exponent
+     * Exact (correctly rounded) for up to 15 significant digits and
+     * decimal exponents up to 22, which covers TSPLIB; longer numbers fall
+     * back to strtod.
+     * @return false (and leaves x) if the next word is not a number
+     */
+    bool read(double &x)
+    {
+      static const double kPow10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6,
+        1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18,
+        1e19, 1e20, 1e21, 1e22 };
+      skip_space();
+      const char *q = p;
+      bool negative = q != end && *q == '-';
+      if (q != end && (*q == '-' || *q == '+')) ++q;
+      uint64_t mantissa = 0;
+      int digits = 0, exponent = 0;
+      bool any = false;
+      // leading zeros are not significant digits; digits past the 19th
+      // only shift the exponent
+      for (; q != end && is_digit(*q); ++q, any = true)
+      {
+        if (!mantissa && *q == '0') continue;
+        if (++digits <= 19) mantissa = 10 * mantissa + (*q - '0');
+        else ++exponent;
+      }
+      if (q != end && *q == '.')
+      {
+        for (++q; q != end && is_digit(*q); ++q, any = true)
+        {
+          if (!mantissa && *q == '0') --exponent;
+          else if (++digits <= 19)
+          {
+            mantissa = 10 * mantissa + (*q - '0');
+            --exponent;
+          }
+        }
+      }
+      if (!any) return false;
+      if (q != end && (*q == 'e' || *q == 'E'))
+      {
+        ++q;
+        bool negative_exp = q != end && *q == '-';
+        if (q != end && (*q == '-' || *q == '+')) ++q;
+        if (q == end || !is_digit(*q)) return false;
+        int e = 0;
+        for (; q != end && is_digit(*q); ++q) if (e < 10000)
+          e = 10 * e + (*q - '0');
+        exponent += negative_exp ? -e : e;
+      }
+      if (q != end && !is_space(*q)) return false;
+      if (digits <= 15 && -22 <= exponent && exponent <= 22)
+      {
+        double v = mantissa;
+        v = exponent < 0 ? v / kPow10[-exponent] : v * kPow10[exponent];
+        x = negative ? -v : v;
+      }
+      else
+      {
+        // at most a few such numbers in a file, copy them
+        x = strtod(std::string(p, q).c_str(), nullptr);
+      }
+      p = q;
+      return true;
+    }
+
+    /** @brief current position */
+    const char *p;
+    const char *end;
+
+    private:
+      static bool is_space(char c)
+      {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r' ||
+          c == '\f' || c == '\v';
+      }
+      static bool is_digit(char c)
+      {
+        return '0' <= c && c <= '9';
+      }
+  };
+}  // namespace tsp
+
+#endif  // TSP_MAPPEDFILE_H_
@@ -0,0 +1,111 @@
+#ifndef TSP_NEIGHBORLISTS_H_
+#define TSP_NEIGHBORLISTS_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "spatial/Grid.h"
+#include "tsp/util.h"
+
+namespace tsp
+{
+  /**
+   * @brief candidate sets: for every vertex, k of its nearest neighbours
+   * sorted by increasing distance
+   */
+  struct NeighborLists
+  {
+    NeighborLists() : k(0) {}
+
+    /** @brief number of neighbours stored per vertex */
+    size_t k;
+
+    /** @brief neighbours of vertex i are ids[i*k, (i+1)*k) */
+    std::vector<uint32_t> ids;
+
+    /** @return number of vertices */
+    size_t size() const
+    {
+      return k ? ids.size() / k : 0;
+    }
+
+    /** @return neighbours of vertex i */
+    const uint32_t * operator[](size_t i) const
+    {
+      return &ids[i * k];
+    }
+  };
+
+  /**
+   * @brief computes neighbour lists by scanning the whole matrix; O(n^2)
+   * @param matrix [implements Matrix]
+   * @param k neighbours per vertex; clamped to n-1
+   */
+  template<typename Matrix>
+  void neighbor_lists_scan(const Matrix &matrix, size_t k,
+      NeighborLists &lists)
+  {
+    size_t n = matrix.size1();
+    lists.k = std::min(k, n ? n - 1 : 0);
+    lists.ids.resize(n * lists.k);
+    if (!lists.k) return;
+    std::vector<std::pair<double, uint32_t> > row;
+    for (size_t i = 0; i < n; ++i)
+    {
+      row.clear();
+      for (size_t j = 0; j < n; ++j)
+        if (j != i) row.push_back(std::make_pair(matrix(i, j), j));
+      std::partial_sort(row.begin(), row.begin() + lists.k, row.end());
+      for (size_t j = 0; j < lists.k; ++j) lists.ids[i * lists.k + j] =
+        row[j].second;
+    }
+  }
+
+  /**
+   * @brief computes euclidean neighbour lists of points bucketed in a
+   * uniform grid (see: spatial::Grid); expected O(n k log k) for evenly
+   * spread points
+   *
+   * The lists are also valid for every metric monotone in the euclidean
+   * distance (e.g. TSPLIB EUC_2D, CEIL_2D, ATT) up to ties.
+   * @param k neighbours per point; clamped to n-1
+   */
+  inline void neighbor_lists_grid(const std::vector<Point> &pos, size_t k,
+      NeighborLists &lists)
+  {
+    size_t n = pos.size();
+    lists.k = std::min(k, n ? n - 1 : 0);
+    lists.ids.resize(n * lists.k);
+    if (!lists.k) return;
+    spatial::Grid grid(pos);
+    std::vector<spatial::Grid::Neighbor> best;
+    // in the order of cells, consecutive queries scan mostly the same cells
+    for (size_t b = 0; b < n; ++b)
+    {
+      uint32_t i = grid.cell_order()[b];
+      grid.knn(grid.cell_points()[b], lists.k, best, i);
+      for (size_t j = 0; j < lists.k; ++j) lists.ids[i * lists.k + j] =
+        best[j].second;
+    }
+  }
+
+  /**
+   * @brief computes neighbour lists, using the grid for matrices backed by
+   * points (see: matrix_points) and a full scan otherwise
+   * @param matrix [implements Matrix]
+   * @param k neighbours per vertex
+   */
+  template<typename Matrix>
+  void neighbor_lists(const Matrix &matrix, size_t k, NeighborLists &lists)
+  {
+    const std::vector<Point> *pos = matrix_points(matrix);
+    if (pos) neighbor_lists_grid(*pos, k, lists);
+    else neighbor_lists_scan(matrix, k, lists);
+  }
+}  // namespace tsp
+
+#endif  // TSP_NEIGHBORLISTS_H_
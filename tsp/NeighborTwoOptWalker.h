@@ -0,0 +1,115 @@
+#ifndef TSP_NEIGHBORTWOOPTWALKER_H_
+#define TSP_NEIGHBORTWOOPTWALKER_H_
+
+#include <cassert>
+#include <vector>
+
+#include "tsp/NeighborLists.h"
+#include "tsp/util.h"
+
+namespace tsp
+{
+  /**
+   * @brief [implements Walker] 2-opt strategy restricted to candidate sets
+   *
+   * Only moves introducing an edge from a vertex to one of its nearest
+   * neighbours are proposed, which on large instances raises the ratio of
+   * accepted moves by orders of magnitude compared to TwoOptWalker.
+   * The shorter of the two equivalent segments is reversed.
+   * @param Matrix [implements Matrix]
+   */
+  template<typename Matrix> struct NeighborTwoOptWalker
+  {
+      /**
+       * @param _matrix [implements Matrix] problem definition (distance matrix)
+       * @param _neighbors candidate sets, see: neighbor_lists
+       * @param _cycle [implements Cycle] initial solution
+       */
+      template<typename Cycle>
+      NeighborTwoOptWalker(const Matrix &_matrix,
+          const NeighborLists &_neighbors, const Cycle &_cycle) :
+        matrix(_matrix), neighbors(_neighbors), begin(0), len(0),
+        cycle(_cycle.size()),
+        pos(_cycle.size())
+      {
+        assert(matrix.size1() == matrix.size2() &&
+               matrix.size1() == _cycle.size() &&
+               neighbors.size() == _cycle.size() && neighbors.k);
+        for (size_t i = 0; i < cycle.size(); ++i) pos[cycle[i] = _cycle[i]] = i;
+        current_fitness_ = next_fitness_ = fitness(matrix, cycle);
+      }
+
+    private:
+      const Matrix &matrix;
+      const NeighborLists &neighbors;
+      double current_fitness_, next_fitness_;
+      /** @brief reversed segment: len nodes from position begin */
+      size_t begin, len;
+
+    public:
+      std::vector<size_t> cycle;
+      /** @brief pos[cycle[i]] == i */
+      std::vector<size_t> pos;
+
+      double current_fitness()
+      {
+        return current_fitness_;
+      }
+      double next_fitness()
+      {
+        return next_fitness_;
+      }
+
+      /**
+       * generates step as a 2-opt move adding edge (a,c), where a is random
+       * and c is a random candidate neighbour of a; if the move is
+       * degenerate, the step is empty.
+       */
+      template<typename Random>
+      void prepare_step(double progress, Random &random)
+      {
+        size_t n = cycle.size();
+        size_t a = cycle[random() % n];
+        size_t c = neighbors[a][random() % neighbors.k];
+        size_t pa = pos[a], pc = pos[c], p, q;
+        if (random() & 1)
+        {
+          // remove (a,succ a), (c,succ c); reverse succ a .. c
+          p = pa + 1 < n ? pa + 1 : 0;
+          q = pc;
+        }
+        else
+        {
+          // remove (pred a,a), (pred c,c); reverse c .. pred a
+          p = pc;
+          q = pa ? pa - 1 : n - 1;
+        }
+        size_t pp = p ? p - 1 : n - 1, qn = q + 1 < n ? q + 1 : 0;
+        len = (q + n - p) % n + 1;
+        if (len < 2 || len > n - 2)
+        {
+          len = 0;
+          next_fitness_ = current_fitness_;
+          return;
+        }
+        next_fitness_ = current_fitness_
+            - matrix(cycle[pp], cycle[p]) - matrix(cycle[q], cycle[qn])
+            + matrix(cycle[pp], cycle[q]) + matrix(cycle[p], cycle[qn]);
+        begin = p;
+        // reversing the complement yields the same cycle
+        if (2 * len > n)
+        {
+          begin = qn;
+          len = n - len;
+        }
+      }
+
+      void make_step()
+      {
+        cycle_reverse_indexed(cycle, pos, begin, len);
+        current_fitness_ = next_fitness_;
+      }
+  };
+}  // namespace tsp
+
+#endif  // TSP_NEIGHBORTWOOPTWALKER_H_
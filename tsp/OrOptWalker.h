@@ -0,0 +1,116 @@
+#ifndef TSP_OROPTWALKER_H_
+#define TSP_OROPTWALKER_H_
+
+// http://en.wikipedia.org/wiki/3-opt
+
+#include <cassert>
+#include <vector>
+
+#include "tsp/util.h"
+
+namespace tsp
+{
+  /**
+   * @brief [implements Walker] Or-opt strategy: moves a short segment
+   * of the cycle to another edge, optionally reversing it.
+   *
+   * Every step is a special case of a 3-opt move, evaluated in O(1).
+   * Making a step costs O(min(shift, n - shift)).
+   * @param Matrix [implements Matrix]
+   */
+  template<typename Matrix> struct OrOptWalker
+  {
+      /**
+       * @param _matrix [implements Matrix] problem definition (distance matrix)
+       * @param _cycle [implements Cycle] initial solution
+       * @param _max_len maximal length of a moved segment
+       */
+      template<typename Cycle>
+      OrOptWalker(const Matrix &_matrix, const Cycle &_cycle,
+          size_t _max_len = 3) :
+        matrix(_matrix), max_len(_max_len), segment(_max_len),
+        cycle(_cycle.begin(), _cycle.end())
+      {
+        assert(matrix.size1() == matrix.size2() &&
+               matrix.size1() == _cycle.size() && max_len);
+        current_fitness_ = fitness(matrix, cycle);
+      }
+
+    private:
+      const Matrix &matrix;
+      size_t max_len;
+      double current_fitness_, next_fitness_;
+      Insertion insertion;
+      /** @brief buffer for the moved segment */
+      std::vector<size_t> segment;
+
+      size_t at(size_t i) const
+      {
+        return cycle[i % cycle.size()];
+      }
+
+    public:
+      std::vector<size_t> cycle;
+
+      double current_fitness()
+      {
+        return current_fitness_;
+      }
+      double next_fitness()
+      {
+        return next_fitness_;
+      }
+
+      /**
+       * generates step as an insertion of a random segment of length
+       * [1,max_len] to a random edge
+       */
+      template<typename Random>
+      void prepare_step(double progress, Random &random)
+      {
+        size_t n = cycle.size();
+        insertion.generate(n, max_len, random);
+        size_t b = insertion.begin + n, e = b + insertion.len - 1;
+        size_t p = at(b - 1), s0 = at(b), s1 = at(e), nx = at(e + 1);
+        size_t u = at(e + insertion.shift), v = at(e + insertion.shift + 1);
+        next_fitness_ = current_fitness_
+            - matrix(p, s0) - matrix(s1, nx) + matrix(p, nx)
+            - matrix(u, v);
+        if (insertion.reversed)
+          next_fitness_ += matrix(u, s1) + matrix(s0, v);
+        else
+          next_fitness_ += matrix(u, s0) + matrix(s1, v);
+      }
+
+      /**
+       * moves the segment past the shorter of the two paths separating
+       * it from the target edge
+       */
+      void make_step()
+      {
+        size_t n = cycle.size(), len = insertion.len;
+        size_t b = insertion.begin + n, shift = insertion.shift;
+        size_t rest = n - len - shift;
+        for (size_t i = 0; i < len; ++i) segment[i] = at(b + i);
+        size_t dst;
+        if (shift <= rest)
+        {
+          for (size_t i = 0; i < shift; ++i)
+            cycle[(b + i) % n] = at(b + len + i);
+          dst = b + shift;
+        }
+        else
+        {
+          for (size_t i = rest; i--;)
+            cycle[(b - rest + len + i) % n] = at(b - rest + i);
+          dst = b - rest;
+        }
+        for (size_t i = 0; i < len; ++i)
+          cycle[(dst + i) % n] =
+            segment[insertion.reversed ? len - 1 - i : i];
+        current_fitness_ = next_fitness_;
+      }
+  };
+}  // namespace tsp
+
+#endif  // TSP_OROPTWALKER_H_
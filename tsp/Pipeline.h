@@ -0,0 +1,170 @@
+#ifndef TSP_PIPELINE_H_
+#define TSP_PIPELINE_H_
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "paal/Logger.h"
+#include "paal/ProgressCtrl.h"
+#include "paal/search.h"
+#include "tsp/Christofides.h"
+#include "tsp/NeighborLists.h"
+#include "tsp/greedy.h"
+#include "tsp/util.h"
+
+namespace tsp
+{
+  /** @brief construction heuristics available in Pipeline::construct */
+  enum ConstructionEnum
+  {
+    /** @brief nearest neighbour, see: greedy */
+    kConstructGreedy,
+    /** @brief eulerian circuit of Christofides, see: christofides_circuit */
+    kConstructChristofides,
+    /** @brief order along the Hilbert curve, see: space_filling_curve;
+     * requires a matrix backed by points (see: matrix_points) */
+    kConstructSpaceFillingCurve,
+    /** @brief see: greedy_edge; requires a matrix backed by points */
+    kConstructGreedyEdge
+  };
+
+  /** @brief wall time spent in the stages of Pipeline, in seconds */
+  struct PipelineTimes
+  {
+    PipelineTimes() : construct(0), shortcut(0), improve(0) {}
+    double construct, shortcut, improve;
+
+    double total() const
+    {
+      return construct + shortcut + improve;
+    }
+  };
+
+  /**
+   * @brief TSP solved in stages: construct a closed walk visiting every
+   * vertex, shortcut it to a cycle, then improve the cycle by local search.
+   *
+   * construct and improve may be called repeatedly (e.g. several
+   * improvements under different ProgressCtrl), the buffers and the
+   * neighbour lists are kept between the calls and between instances of
+   * the same size. The time of every stage is accumulated in times, so the
+   * time left for the next stage is budget - times.total().
+   * @param Matrix [implements Matrix] ASSUMPTION: symmetric
+   */
+  template<typename Matrix> struct Pipeline
+  {
+    /** @param _matrix [implements Matrix] problem definition */
+    explicit Pipeline(const Matrix &_matrix) :
+      matrix(_matrix), matching(kMatchingGreedy), matching_neighbors(10),
+      points(nullptr), neighbors_k(0) {}
+
+    const Matrix &matrix;
+
+    /** @brief matching used by kConstructChristofides, see: christofides */
+    MatchingImplEnum matching;
+    /** @brief candidates per vertex of sparse and greedy matchings */
+    size_t matching_neighbors;
+    /** @brief TSPLIB edge weight type and points for the dense matching,
+     * see: christofides */
+    std::string ewt;
+    std::vector<Point> *points;
+
+    /** @brief closed walk visiting every vertex, output of construct */
+    std::vector<uint32_t> circuit;
+    /** @brief hamiltonian cycle, output of shortcut and improve */
+    std::vector<size_t> cycle;
+    PipelineTimes times;
+
+    /**
+     * @brief candidate sets for the improving walkers, computed on first use
+     * and reused while k does not change
+     * @param k neighbours per vertex, see: neighbor_lists
+     */
+    const NeighborLists & neighbors(size_t k)
+    {
+      if (k != neighbors_k || lists.size() != matrix.size1())
+      {
+        double begin = paal::realtime_sec();
+        neighbor_lists(matrix, k, lists);
+        neighbors_k = k;
+        times.improve += paal::realtime_sec() - begin;
+      }
+      return lists;
+    }
+
+    /** @brief fills circuit using the given heuristic */
+    void construct(ConstructionEnum how)
+    {
+      double begin = paal::realtime_sec();
+      size_t n = matrix.size1();
+      switch (how)
+      {
+        case kConstructGreedy:
+          greedy(matrix, circuit);
+          break;
+        case kConstructChristofides:
+          christofides_circuit(matrix, circuit, n, ewt, points, matching,
+              matching_neighbors);
+          break;
+        case kConstructSpaceFillingCurve:
+          assert(matrix_points(matrix));
+          space_filling_curve(*matrix_points(matrix), circuit);
+          break;
+        case kConstructGreedyEdge:
+          assert(matrix_points(matrix));
+          greedy_edge(*matrix_points(matrix), circuit);
+          break;
+      }
+      times.construct += paal::realtime_sec() - begin;
+    }
+
+    /** @brief turns circuit into cycle skipping visited vertices,
+     * see: find_hamiltonian_cycle */
+    void shortcut()
+    {
+      double begin = paal::realtime_sec();
+      cycle.resize(matrix.size1());
+      find_hamiltonian_cycle(circuit, &cycle, cycle.size());
+      times.shortcut += paal::realtime_sec() - begin;
+    }
+
+    /** @brief construct followed by shortcut */
+    void construct_cycle(ConstructionEnum how)
+    {
+      construct(how);
+      shortcut();
+    }
+
+    /**
+     * @brief runs paal::search on the walker and stores its cycle
+     * @param walker [implements Walker] constructed from cycle,
+     *        exposing the cycle it walks on as the cycle member
+     * @param random [implements Random]
+     * @param progress_ctrl [implements ProgressCtrl]
+     * @param step_ctrl [implements StepCtrl]
+     * @return fitness of the improved cycle
+     */
+    template<typename Walker, typename Random, typename ProgressCtrl,
+      typename StepCtrl>
+    double improve(Walker &walker, Random &random,
+        ProgressCtrl &progress_ctrl, StepCtrl &step_ctrl)
+    {
+      double begin = paal::realtime_sec();
+      paal::VoidLogger logger;
+      paal::search(walker, random, progress_ctrl, step_ctrl, logger);
+      const auto &result = walker.cycle;
+      cycle.resize(result.size());
+      for (size_t i = 0; i < cycle.size(); ++i) cycle[i] = result[i];
+      times.improve += paal::realtime_sec() - begin;
+      return walker.current_fitness();
+    }
+
+    private:
+      NeighborLists lists;
+      size_t neighbors_k;
+  };
+}  // namespace tsp
+
+#endif  // TSP_PIPELINE_H_
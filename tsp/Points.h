@@ -0,0 +1,210 @@
+#ifndef TSP_POINTS_H_
+#define TSP_POINTS_H_
+
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "tsp/util.h"
+
+namespace tsp
+{
+  /**
+   * @brief structure of arrays representation of points with ids,
+   * suitable for the batch kernels below
+   */
+  struct Points
+  {
+    Points() {}
+    /** @brief copies pos; ids are indices in pos */
+    explicit Points(const std::vector<Point> &pos) :
+      x(pos.size()), y(pos.size()), id(pos.size())
+    {
+      for (size_t i = 0; i < pos.size(); ++i)
+      {
+        x[i] = pos[i].x;
+        y[i] = pos[i].y;
+        id[i] = i;
+      }
+    }
+
+    size_t size() const
+    {
+      return x.size();
+    }
+
+    Point operator[](size_t i) const
+    {
+      return Point(x[i], y[i]);
+    }
+
+    /** @brief removes i-th point in O(1), moving the last one in its place */
+    void swap_remove(size_t i)
+    {
+      x[i] = x.back();
+      y[i] = y.back();
+      id[i] = id.back();
+      x.pop_back();
+      y.pop_back();
+      id.pop_back();
+    }
+
+    /** @brief coordinates */
+    std::vector<double> x, y;
+    /** @brief point identifiers */
+    std::vector<uint32_t> id;
+  };
+
+  /**
+   * @brief out[j] = |(x[j],y[j]) - p|^2 for j in [0,n)
+   * uses AVX or SSE2 if enabled at compile time
+   */
+  inline void sqr_distances(const double *x, const double *y, size_t n,
+      Point p, double *out)
+  {
+    size_t j = 0;
+#if defined(__AVX__)
+    __m256d px = _mm256_set1_pd(p.x), py = _mm256_set1_pd(p.y);
+    for (; j + 4 <= n; j += 4)
+    {
+      __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + j), px);
+      __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + j), py);
+      _mm256_storeu_pd(out + j,
+          _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)));
+    }
+#elif defined(__SSE2__)
+    __m128d px = _mm_set1_pd(p.x), py = _mm_set1_pd(p.y);
+    for (; j + 2 <= n; j += 2)
+    {
+      __m128d dx = _mm_sub_pd(_mm_loadu_pd(x + j), px);
+      __m128d dy = _mm_sub_pd(_mm_loadu_pd(y + j), py);
+      _mm_storeu_pd(out + j,
+          _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)));
+    }
+#endif
+    for (; j < n; ++j)
+      out[j] = (x[j] - p.x) * (x[j] - p.x) + (y[j] - p.y) * (y[j] - p.y);
+  }
+
+  /**
+   * @brief reduces lanes of a vectorized argmin into best, best_i;
+   * the lowest index wins on ties
+   */
+  inline void argmin_lanes(const double *val, const double *idx,
+      size_t lanes, double &best, size_t &best_i)
+  {
+    for (size_t l = 0; l < lanes; ++l)
+      if (val[l] < best || (val[l] == best && idx[l] < best_i))
+      {
+        best = val[l];
+        best_i = idx[l];
+      }
+  }
+
+  /**
+   * @brief index of the point of [0,n) closest to p; the lowest one on ties
+   * uses AVX or SSE2 if enabled at compile time
+   *
+   * ASSUMPTION: n > 0
+   */
+  inline size_t argmin_sqr_distance(const double *x, const double *y,
+      size_t n, Point p)
+  {
+    assert(n);
+    double best = std::numeric_limits<double>::infinity();
+    size_t best_i = 0, j = 0;
+#if defined(__AVX__)
+    __m256d px = _mm256_set1_pd(p.x), py = _mm256_set1_pd(p.y);
+    __m256d bv = _mm256_set1_pd(best), bi = _mm256_setzero_pd();
+    __m256d idx = _mm256_set_pd(3, 2, 1, 0), four = _mm256_set1_pd(4);
+    for (; j + 4 <= n; j += 4, idx = _mm256_add_pd(idx, four))
+    {
+      __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + j), px);
+      __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + j), py);
+      __m256d d = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+      __m256d lt = _mm256_cmp_pd(d, bv, _CMP_LT_OQ);
+      bv = _mm256_blendv_pd(bv, d, lt);
+      bi = _mm256_blendv_pd(bi, idx, lt);
+    }
+    double val[4], ids[4];
+    _mm256_storeu_pd(val, bv);
+    _mm256_storeu_pd(ids, bi);
+    argmin_lanes(val, ids, 4, best, best_i);
+#elif defined(__SSE2__)
+    __m128d px = _mm_set1_pd(p.x), py = _mm_set1_pd(p.y);
+    __m128d bv = _mm_set1_pd(best), bi = _mm_setzero_pd();
+    __m128d idx = _mm_set_pd(1, 0), two = _mm_set1_pd(2);
+    for (; j + 2 <= n; j += 2, idx = _mm_add_pd(idx, two))
+    {
+      __m128d dx = _mm_sub_pd(_mm_loadu_pd(x + j), px);
+      __m128d dy = _mm_sub_pd(_mm_loadu_pd(y + j), py);
+      __m128d d = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+      __m128d lt = _mm_cmplt_pd(d, bv);
+      bv = _mm_or_pd(_mm_and_pd(lt, d), _mm_andnot_pd(lt, bv));
+      bi = _mm_or_pd(_mm_and_pd(lt, idx), _mm_andnot_pd(lt, bi));
+    }
+    double val[2], ids[2];
+    _mm_storeu_pd(val, bv);
+    _mm_storeu_pd(ids, bi);
+    argmin_lanes(val, ids, 2, best, best_i);
+#endif
+    for (; j < n; ++j)
+    {
+      double d = (x[j] - p.x) * (x[j] - p.x) + (y[j] - p.y) * (y[j] - p.y);
+      if (d < best) best = d, best_i = j;
+    }
+    return best_i;
+  }
+
+  /**
+   * @brief index of the minimal value of v[0,n); the lowest one on ties
+   * uses AVX or SSE2 if enabled at compile time
+   *
+   * ASSUMPTION: n > 0
+   */
+  inline size_t argmin(const double *v, size_t n)
+  {
+    assert(n);
+    double best = std::numeric_limits<double>::infinity();
+    size_t best_i = 0, j = 0;
+#if defined(__AVX__)
+    __m256d bv = _mm256_set1_pd(best), bi = _mm256_setzero_pd();
+    __m256d idx = _mm256_set_pd(3, 2, 1, 0), four = _mm256_set1_pd(4);
+    for (; j + 4 <= n; j += 4, idx = _mm256_add_pd(idx, four))
+    {
+      __m256d d = _mm256_loadu_pd(v + j);
+      __m256d lt = _mm256_cmp_pd(d, bv, _CMP_LT_OQ);
+      bv = _mm256_blendv_pd(bv, d, lt);
+      bi = _mm256_blendv_pd(bi, idx, lt);
+    }
+    double val[4], ids[4];
+    _mm256_storeu_pd(val, bv);
+    _mm256_storeu_pd(ids, bi);
+    argmin_lanes(val, ids, 4, best, best_i);
+#elif defined(__SSE2__)
+    __m128d bv = _mm_set1_pd(best), bi = _mm_setzero_pd();
+    __m128d idx = _mm_set_pd(1, 0), two = _mm_set1_pd(2);
+    for (; j + 2 <= n; j += 2, idx = _mm_add_pd(idx, two))
+    {
+      __m128d d = _mm_loadu_pd(v + j);
+      __m128d lt = _mm_cmplt_pd(d, bv);
+      bv = _mm_or_pd(_mm_and_pd(lt, d), _mm_andnot_pd(lt, bv));
+      bi = _mm_or_pd(_mm_and_pd(lt, idx), _mm_andnot_pd(lt, bi));
+    }
+    double val[2], ids[2];
+    _mm_storeu_pd(val, bv);
+    _mm_storeu_pd(ids, bi);
+    argmin_lanes(val, ids, 2, best, best_i);
+#endif
+    for (; j < n; ++j)
+      if (v[j] < best) best = v[j], best_i = j;
+    return best_i;
+  }
+}  // namespace tsp
+
+#endif  // TSP_POINTS_H_
@@ -0,0 +1,172 @@
+#ifndef TSP_QUEUETWOOPTWALKER_H_
+#define TSP_QUEUETWOOPTWALKER_H_
+
+#include <cassert>
+#include <deque>
+#include <vector>
+
+#include "tsp/NeighborLists.h"
+#include "tsp/util.h"
+
+namespace tsp
+{
+  /**
+   * @brief [implements Walker] deterministic first-improvement 2-opt
+   * with don't-look bits
+   *
+   * Vertices whose neighbourhood may contain an improving move are kept in
+   * a FIFO queue. A vertex leaves the queue once none of the 2-opt moves
+   * adding an edge to one of its candidate neighbours improves the cycle;
+   * the endpoints of every applied move are queued again. A reversal also
+   * turns its segment relative to the rest of the cycle, which creates new
+   * moves between vertices whose edges did not change, so once the queue
+   * runs out all vertices are queued again, unless no move was made since
+   * the last such sweep. Then the cycle is 2-opt optimal with respect to
+   * the candidate sets and converged() holds, see: paal::ConvergenceCtrl.
+   *
+   * Every proposed step is improving; random is not used.
+   * @param Matrix [implements Matrix] ASSUMPTION: symmetric
+   */
+  template<typename Matrix> struct QueueTwoOptWalker
+  {
+      /**
+       * @param _matrix [implements Matrix] problem definition (distance matrix)
+       * @param _neighbors candidate sets, see: neighbor_lists
+       * @param _cycle [implements Cycle] initial solution
+       */
+      template<typename Cycle>
+      QueueTwoOptWalker(const Matrix &_matrix,
+          const NeighborLists &_neighbors, const Cycle &_cycle) :
+        matrix(_matrix), neighbors(_neighbors), begin(0), len(0),
+        steps_since_sweep(0), queued(_cycle.size(), true),
+        cycle(_cycle.size()),
+        pos(_cycle.size())
+      {
+        assert(matrix.size1() == matrix.size2() &&
+               matrix.size1() == _cycle.size() &&
+               neighbors.size() == _cycle.size());
+        for (size_t i = 0; i < cycle.size(); ++i) pos[cycle[i] = _cycle[i]] = i;
+        queue.assign(cycle.begin(), cycle.end());
+        current_fitness_ = next_fitness_ = fitness(matrix, cycle);
+      }
+
+    private:
+      /** @brief minimal improvement of an accepted move */
+      static constexpr double kEps = 1e-9;
+
+      const Matrix &matrix;
+      const NeighborLists &neighbors;
+      double current_fitness_, next_fitness_;
+      /** @brief reversed segment: len nodes from position begin */
+      size_t begin, len;
+      /** @brief number of moves made since all vertices were queued */
+      size_t steps_since_sweep;
+      /** @brief vertices with cleared don't-look bits */
+      std::deque<size_t> queue;
+      std::vector<bool> queued;
+
+      void push(size_t v)
+      {
+        if (queued[v]) return;
+        queued[v] = true;
+        queue.push_back(v);
+      }
+
+      /**
+       * @brief looks for an improving move adding an edge (a,c)
+       * @returns true iff found; the move is stored in begin, len
+       */
+      bool find_move(size_t a)
+      {
+        size_t n = cycle.size(), pa = pos[a];
+        for (int dir = 0; dir < 2; ++dir)
+        {
+          // succ: remove (a,succ a), (c,succ c); reverse succ a .. c
+          // pred: remove (pred a,a), (pred c,c); reverse c .. pred a
+          size_t an = cycle[dir ? (pa ? pa - 1 : n - 1) : (pa + 1) % n];
+          double d_an = matrix(a, an);
+          for (size_t k = 0; k < neighbors.k; ++k)
+          {
+            size_t c = neighbors[a][k], pc = pos[c];
+            double d_ac = matrix(a, c);
+            if (d_ac >= d_an) break;
+            size_t cn = cycle[dir ? (pc ? pc - 1 : n - 1) : (pc + 1) % n];
+            if (c == an || cn == a) continue;
+            double delta = d_ac + matrix(an, cn) - d_an - matrix(c, cn);
+            if (delta > -kEps) continue;
+            size_t p = dir ? pc : pos[an], q = dir ? pos[an] : pc;
+            len = (q + n - p) % n + 1;
+            begin = p;
+            // reversing the complement yields the same cycle
+            if (2 * len > n)
+            {
+              begin = (q + 1) % n;
+              len = n - len;
+            }
+            next_fitness_ = current_fitness_ + delta;
+            return true;
+          }
+        }
+        return false;
+      }
+
+    public:
+      std::vector<size_t> cycle;
+      /** @brief pos[cycle[i]] == i */
+      std::vector<size_t> pos;
+
+      double current_fitness()
+      {
+        return current_fitness_;
+      }
+      double next_fitness()
+      {
+        return next_fitness_;
+      }
+
+      /** @returns true iff no improving move is left */
+      bool converged() const
+      {
+        return queue.empty();
+      }
+
+      /**
+       * finds the first improving move of the vertex at the front of the
+       * queue, dropping vertices without one; if there is no improving move
+       * at all, the step is empty.
+       */
+      template<typename Random>
+      void prepare_step(double progress, Random &random)
+      {
+        while (!queue.empty())
+        {
+          if (find_move(queue.front())) return;
+          queued[queue.front()] = false;
+          queue.pop_front();
+          if (queue.empty() && steps_since_sweep)
+          {
+            steps_since_sweep = 0;
+            for (size_t v : cycle) push(v);
+          }
+        }
+        len = 0;
+        next_fitness_ = current_fitness_;
+      }
+
+      void make_step()
+      {
+        current_fitness_ = next_fitness_;
+        if (!len) return;
+        steps_since_sweep++;
+        size_t n = cycle.size(), end = (begin + len - 1) % n;
+        push(cycle[begin ? begin - 1 : n - 1]);
+        push(cycle[begin]);
+        push(cycle[end]);
+        push(cycle[(end + 1) % n]);
+        cycle_reverse_indexed(cycle, pos, begin, len);
+        len = 0;
+      }
+  };
+}  // namespace tsp
+
+#endif  // TSP_QUEUETWOOPTWALKER_H_
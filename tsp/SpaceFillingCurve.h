@@ -0,0 +1,72 @@
+#ifndef TSP_SPACEFILLINGCURVE_H_
+#define TSP_SPACEFILLINGCURVE_H_
+
+// http://en.wikipedia.org/wiki/Hilbert_curve
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "tsp/util.h"
+
+namespace tsp
+{
+  /**
+   * @brief position of cell (x,y) along the Hilbert curve filling
+   * the [0,2^order)^2 grid
+   */
+  inline uint64_t hilbert_index(uint32_t x, uint32_t y, unsigned order = 16)
+  {
+    uint32_t n = 1u << order;
+    uint64_t d = 0;
+    for (uint32_t s = n / 2; s; s /= 2)
+    {
+      uint32_t rx = (x & s) != 0, ry = (y & s) != 0;
+      d += uint64_t(s) * s * ((3 * rx) ^ ry);
+      // rotates the quadrant, so that the curve inside it is canonical;
+      // branch free, as the bits of random points are unpredictable
+      uint32_t swap = -(ry ^ 1), flip = swap & -rx & (n - 1);
+      x ^= flip;
+      y ^= flip;
+      uint32_t t = (x ^ y) & swap;
+      x ^= t;
+      y ^= t;
+    }
+    return d;
+  }
+
+  /**
+   * @brief sorts points along the Hilbert curve laid over their bounding box;
+   * consecutive points are usually close to each other. O(n log n)
+   * @param pos points
+   * @param order vector to store indices of pos in
+   */
+  template<typename Index>
+  void hilbert_sort(const std::vector<Point> &pos, std::vector<Index> &order)
+  {
+    enum { kOrder = 16 };
+    size_t n = pos.size();
+    order.resize(n);
+    if (!n) return;
+    Point lo = pos[0], hi = pos[0];
+    for (const Point & p : pos)
+    {
+      lo = Point(std::min(lo.x, p.x), std::min(lo.y, p.y));
+      hi = Point(std::max(hi.x, p.x), std::max(hi.y, p.y));
+    }
+    // keeps the aspect ratio, so that the curve is not stretched
+    double side = std::max(std::max(hi.x - lo.x, hi.y - lo.y), 1e-12);
+    double scale = ((1u << kOrder) - 1) / side;
+    // the index of the cell in high bits, the index of the point in low
+    assert(n <= 0xffffffffu);
+    std::vector<uint64_t> keys(n);
+    for (size_t i = 0; i < n; ++i)
+      keys[i] = hilbert_index((pos[i].x - lo.x) * scale,
+          (pos[i].y - lo.y) * scale, kOrder) << 32 | i;
+    std::sort(keys.begin(), keys.end());
+    for (size_t i = 0; i < n; ++i) order[i] = keys[i] & 0xffffffffu;
+  }
+}  // namespace tsp
+
+#endif  // TSP_SPACEFILLINGCURVE_H_
@@ -3,29 +3,39 @@
 
 
 #include <boost/numeric/ublas/matrix.hpp>
+#include <sys/stat.h>
+#include <unistd.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <istream>  // NOLINT
 #include <fstream>  // NOLINT
 #include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 #include <map>
 
+#include "tsp/MappedFile.h"
 #include "tsp/util.h"
 #include "./format.h"
 
 namespace tsp
 {
+  struct TSPLIB_ExplicitView;
+
   /**
    * @brief [implements Matrix] represents TSPLIB test cases
    */
   struct TSPLIB_Matrix
   {
-    TSPLIB_Matrix() : size_(0) {}
+    TSPLIB_Matrix() : dist_(0), size_(0) {}
     typedef double value_type;
 
     /** @brief type of a metric */
@@ -93,6 +103,20 @@ namespace tsp
       return size_;
     }
 
+    /**
+     * @brief calls visitor with a view of this matrix, which has the
+     * current metric fixed at compile time, so that the distance
+     * computations of algorithms instantiated with it are inlined
+     *
+     * The view is one of TSPLIB_View<EuclDist>, TSPLIB_View<CeilDist>,
+     * TSPLIB_View<AttDist> and TSPLIB_ExplicitView (also used for GEO,
+     * whose distances are computed on load).
+     * @param visitor functor with a templated operator() accepting any of
+     *   the views and returning the same type for all of them
+     */
+    template<typename Visitor> auto with_metric(Visitor &&visitor) const
+      -> decltype(visitor(std::declval<const TSPLIB_ExplicitView &>()));
+
     /** @brief currently used TSPLIB metric; 0 if values stored explicitly */
     Dist dist_;
 
@@ -106,6 +130,115 @@ namespace tsp
     std::vector<Point> pos;
   };
 
+  /** @brief see: tsp::matrix_points; GEO and EXPLICIT instances have none */
+  inline const std::vector<Point> * matrix_points(const TSPLIB_Matrix &matrix)
+  {
+    return matrix.dist_ ? &matrix.pos : nullptr;
+  }
+
+  /** @brief TSPLIB EUCL_DIST functor */
+  struct EuclDist
+  {
+    int operator()(Point d) const
+    {
+      return TSPLIB_Matrix::eucl_dist(d);
+    }
+  };
+
+  /** @brief TSPLIB CEIL_DIST functor */
+  struct CeilDist
+  {
+    int operator()(Point d) const
+    {
+      return TSPLIB_Matrix::ceil_dist(d);
+    }
+  };
+
+  /** @brief TSPLIB ATT_DIST functor */
+  struct AttDist
+  {
+    int operator()(Point d) const
+    {
+      return TSPLIB_Matrix::att_dist(d);
+    }
+  };
+
+  /**
+   * @brief [implements Matrix] points of a TSPLIB_Matrix with the metric
+   * fixed at compile time, see: TSPLIB_Matrix::with_metric
+   * @param Metric one of EuclDist, CeilDist, AttDist
+   */
+  template<typename Metric> struct TSPLIB_View
+  {
+    typedef int value_type;
+
+    explicit TSPLIB_View(const TSPLIB_Matrix &matrix) : pos(matrix.pos) {}
+
+    int operator()(size_t i, size_t j) const
+    {
+      return Metric()(pos[i] - pos[j]);
+    }
+
+    size_t size1() const
+    {
+      return pos.size();
+    }
+    size_t size2() const
+    {
+      return pos.size();
+    }
+
+    /** @brief represented points */
+    const std::vector<Point> &pos;
+  };
+
+  /** @brief see: tsp::matrix_points */
+  template<typename Metric>
+  const std::vector<Point> * matrix_points(const TSPLIB_View<Metric> &matrix)
+  {
+    return &matrix.pos;
+  }
+
+  /**
+   * @brief [implements Matrix] explicitly stored values of a TSPLIB_Matrix,
+   * see: TSPLIB_Matrix::with_metric
+   */
+  struct TSPLIB_ExplicitView
+  {
+    typedef int value_type;
+
+    explicit TSPLIB_ExplicitView(const TSPLIB_Matrix &matrix) :
+      mtx(matrix.mtx) {}
+
+    int operator()(size_t i, size_t j) const
+    {
+      return mtx(i, j);
+    }
+
+    size_t size1() const
+    {
+      return mtx.size1();
+    }
+    size_t size2() const
+    {
+      return mtx.size2();
+    }
+
+    /** @brief explicit values representation */
+    const boost::numeric::ublas::matrix<int> &mtx;
+  };
+
+  template<typename Visitor> auto TSPLIB_Matrix::with_metric(
+      Visitor &&visitor) const
+    -> decltype(visitor(std::declval<const TSPLIB_ExplicitView &>()))
+  {
+    if (dist_ == eucl_dist) return visitor(TSPLIB_View<EuclDist>(*this));
+    if (dist_ == ceil_dist) return visitor(TSPLIB_View<CeilDist>(*this));
+    if (dist_ == att_dist) return visitor(TSPLIB_View<AttDist>(*this));
+    assert(!dist_);
+    return visitor(TSPLIB_ExplicitView(*this));
+  }
+
   /**
    * @brief represents TSPLIB/ test case directory created by `make TSPLIB`
    * see: http://www.iwr.uni-heidelberg.de/groups/comopt/software/TSPLIB95/
@@ -169,73 +302,94 @@ namespace tsp
         return int(RRR * acos(.5 * ((1. + q1) * q2 - (1. - q1) * q3)) + 1.0); // NOLINT
       }
 
+      /** @brief path of the binary cache of the test case, see: load */
+      std::string cache_filename() const
+      {
+        return filename + ".bin";
+      }
+
       /**
        * @brief loads test case from file to m
+       *
+       * The file is memory mapped and parsed in place. With use_cache, the
+       * parsed instance is saved to cache_filename(), and later loads map
+       * that file instead of parsing, as long as the size and the
+       * modification time (in nanoseconds) of the test case are the ones
+       * it was made from. The cache holds a CacheHeader followed by the
+       * points as pairs of doubles or by the explicit matrix, row by row,
+       * as int32_t: its lower triangle if symmetric, all of it otherwise.
+       * A cache that cannot be written is silently skipped.
+       * @throws std::runtime_error if the file is malformed or uses an
+       *   unimplemented format
        * @return ewt type of graph.
        */
-      std::string load(TSPLIB_Matrix &m)
+      std::string load(TSPLIB_Matrix &m, bool use_cache = false)
       {
-        std::ifstream is(filename.c_str());
-        assert(is);
-        expect_header(is, "DIMENSION");
-        size_t n;
-        assert(is >> n);
-        expect_header(is, "EDGE_WEIGHT_TYPE");
         std::string ewt;
-        assert(is >> ewt);
+        struct stat source;
+        // the version parsed below is at least as new as this one
+        if (use_cache && stat(filename.c_str(), &source)) use_cache = false;
+        if (use_cache && load_cache(m, ewt, source)) return ewt;
+        MappedFile file(filename);
+        TextScanner is(file.begin(), file.end());
+        // specification part: "KEYWORD : value" lines up to a section
+        std::map<std::string, std::string> spec;
+        std::string section;
+        while (is.skip_space())
+        {
+          std::string line = is.line();
+          size_t colon = line.find(':');
+          if (colon == std::string::npos)
+          {
+            section = trim(line);
+            break;
+          }
+          spec[trim(line.substr(0, colon))] = trim(line.substr(colon + 1));
+        }
+        size_t n = std::stoul(require(spec, "DIMENSION"));
+        ewt = require(spec, "EDGE_WEIGHT_TYPE");
         if (ewt == "EXPLICIT")
         {
-          expect_header(is, "EDGE_WEIGHT_FORMAT");
-          std::string ewf;
-          assert(is >> ewf);
+          std::string ewf = require(spec, "EDGE_WEIGHT_FORMAT");
           m.resize(n, n);
-          expect(is, "EDGE_WEIGHT_SECTION");
+          expect(is, section, "EDGE_WEIGHT_SECTION");
           if (ewf == "FULL_MATRIX")
             for (size_t i = 0; i < n; ++i)
               for (size_t j = 0; j < n; ++j)
-                assert(is >> m.mtx(i, j));
+                m.mtx(i, j) = read<int>(is);
           else if (ewf == "UPPER_ROW")
           {
             for (size_t i = 0; i < n; ++i) m.mtx(i, i) = 0;
             for (size_t i = 0; i < n; ++i)
               for (size_t j = i + 1; j < n; ++j)
-              {
-                int d;
-                assert(is >> d);
-                m.mtx(i, j) = m.mtx(j, i) = d;
-              }
+                m.mtx(i, j) = m.mtx(j, i) = read<int>(is);
           }
           else if (ewf == "LOWER_DIAG_ROW")  // NOLINT
             for (size_t i = 0; i < n; ++i)
               for (size_t j = 0; j <= i; ++j)
-              {
-                int d;
-                assert(is >> d);
-                m.mtx(i, j) = m.mtx(j, i) = d;
-              }
+                m.mtx(i, j) = m.mtx(j, i) = read<int>(is);
           else if (ewf == "UPPER_DIAG_ROW")  // NOLINT
             for (size_t i = 0; i < n; ++i)
               for (size_t j = i; j < n; ++j)
-              {
-                int d;
-                assert(is >> d);
-                m.mtx(i, j) = m.mtx(j, i) = d;
-              }
+                m.mtx(i, j) = m.mtx(j, i) = read<int>(is);
           else throw std::runtime_error(  //NOLINT
               format("EDGE_WEIGHT_FORMAT % is unimplemented", ewf));
         }
         else if (ewt == "GEO")  // NOLINT
         {
-          expect(is, "NODE_COORD_SECTION");
+          expect(is, section, "NODE_COORD_SECTION");
           std::vector<Point> pos(n);
-          int _;
           for (size_t i = 0; i < n; ++i)
-            assert(is >> _ >> pos[i].y >> pos[i].x);
-            for (Point & p : pos) p = Point(geo_rad(p.x), geo_rad(p.y));
-            m.resize(n, n);
-            for (size_t i = 0; i < n; ++i)
-              for (size_t j = i; j < n; ++j)
-                m.mtx(i, j) = m.mtx(j, i) = geo_dist(pos[i], pos[j]);
+          {
+            read<int>(is);
+            pos[i].y = read<double>(is);
+            pos[i].x = read<double>(is);
+          }
+          for (Point & p : pos) p = Point(geo_rad(p.x), geo_rad(p.y));
+          m.resize(n, n);
+          for (size_t i = 0; i < n; ++i)
+            for (size_t j = i; j < n; ++j)
+              m.mtx(i, j) = m.mtx(j, i) = geo_dist(pos[i], pos[j]);
         }
         else  // NOLINT
         {
@@ -245,13 +399,193 @@ namespace tsp
           else
             throw std::runtime_error(
               format("EDGE_WEIGHT_TYPE % is unimplemented", ewt));
-          expect(is, "NODE_COORD_SECTION");
-          int _;
+          expect(is, section, "NODE_COORD_SECTION");
           for (size_t i = 0; i < n; ++i)
-            assert(is >> _ >> m.pos[i].x >> m.pos[i].y);
+          {
+            read<int>(is);
+            m.pos[i].x = read<double>(is);
+            m.pos[i].y = read<double>(is);
+          }
         }
+        if (use_cache) save_cache(m, ewt, source);
         return ewt;
       }
+
+      /** @brief header of the binary cache, see: load */
+      struct CacheHeader
+      {
+        char magic[8];
+        uint64_t size;
+        /** @brief 0 for explicit values, 1-3 for EUC_2D, CEIL_2D, ATT */
+        uint32_t metric;
+        /** @brief explicit values: 0 for the lower triangle, 1 for the
+         * full matrix */
+        uint32_t full;
+        char ewt[20];
+        /** @brief size and modification time of the test case */
+        uint64_t source_size;
+        int64_t source_sec, source_nsec;
+      };
+
+      private:
+        static const char * cache_magic()
+        {
+          return "TSPLIB2";
+        }
+
+        static std::string trim(const std::string &s)
+        {
+          size_t b = s.find_first_not_of(" \t\r");
+          size_t e = s.find_last_not_of(" \t\r");
+          return b == std::string::npos ? "" : s.substr(b, e - b + 1);
+        }
+
+        std::string require(const std::map<std::string, std::string> &spec,
+            const std::string &keyword) const
+        {
+          auto it = spec.find(keyword);
+          if (it == spec.end()) throw std::runtime_error(
+              format("% has no %", filename, keyword));
+          return it->second;
+        }
+
+        /** @brief skips words up to the given section keyword */
+        void expect(TextScanner &is, const std::string &section,
+            const std::string &pattern) const
+        {
+          for (std::string s = section; s != pattern; s = is.word())
+            if (!is.skip_space()) throw std::runtime_error(
+                format("% has no %", filename, pattern));
+        }
+
+        template<typename T> T read(TextScanner &is) const
+        {
+          T x;
+          if (!is.read(x)) throw std::runtime_error(
+              format("malformed number in %", filename));
+          return x;
+        }
+
+        static int metric_id(TSPLIB_Matrix::Dist dist)
+        {
+          if (dist == TSPLIB_Matrix::eucl_dist) return 1;
+          if (dist == TSPLIB_Matrix::ceil_dist) return 2;
+          if (dist == TSPLIB_Matrix::att_dist) return 3;
+          return 0;
+        }
+
+        /** @brief records size and modification time of source */
+        static void set_source(CacheHeader &header, const struct stat &source)
+        {
+          header.source_size = source.st_size;
+          header.source_sec = source.st_mtim.tv_sec;
+          header.source_nsec = source.st_mtim.tv_nsec;
+        }
+
+        bool load_cache(TSPLIB_Matrix &m, std::string &ewt,
+            const struct stat &source) const
+        {
+          if (access(cache_filename().c_str(), R_OK)) return false;
+          MappedFile file(cache_filename());
+          CacheHeader header, expected;
+          if (file.size() < sizeof(header)) return false;
+          memcpy(&header, file.begin(), sizeof(header));
+          set_source(expected, source);
+          if (memcmp(header.magic, cache_magic(), sizeof(header.magic)) ||
+              header.metric > 3 || header.full > 1 ||
+              header.ewt[sizeof(header.ewt) - 1] ||
+              header.source_size != expected.source_size ||
+              header.source_sec != expected.source_sec ||
+              header.source_nsec != expected.source_nsec)
+            return false;
+          size_t n = header.size;
+          const char *data = file.begin() + sizeof(header);
+          if (header.metric)
+          {
+            if (file.size() != sizeof(header) + 2 * n * sizeof(double))
+              return false;
+            static const TSPLIB_Matrix::Dist dists[] = { nullptr,
+              TSPLIB_Matrix::eucl_dist, TSPLIB_Matrix::ceil_dist,
+              TSPLIB_Matrix::att_dist };
+            m.resize(n, n, dists[header.metric]);
+            for (size_t i = 0; i < n; ++i, data += 2 * sizeof(double))
+            {
+              memcpy(&m.pos[i].x, data, sizeof(double));
+              memcpy(&m.pos[i].y, data + sizeof(double), sizeof(double));
+            }
+          }
+          else if (header.full)
+          {
+            if (file.size() != sizeof(header) + n * n * 4) return false;
+            static_assert(sizeof(int) == 4, "rows are copied as int32_t");
+            m.resize(n, n);
+            for (size_t i = 0; i < n; ++i, data += 4 * n)
+              memcpy(&m.mtx(i, 0), data, 4 * n);
+          }
+          else
+          {
+            if (file.size() != sizeof(header) + n * (n + 1) / 2 * 4)
+              return false;
+            m.resize(n, n);
+            for (size_t i = 0; i < n; ++i, data += 4 * i)
+              memcpy(&m.mtx(i, 0), data, 4 * (i + 1));
+            // upper triangle in square blocks, which stay in the cache
+            enum { kBlock = 64 };
+            for (size_t bi = 0; bi < n; bi += kBlock)
+              for (size_t bj = bi; bj < n; bj += kBlock)
+                for (size_t i = bi; i < std::min<size_t>(n, bi + kBlock); ++i)
+                  for (size_t j = std::max(bj, i + 1);
+                      j < std::min<size_t>(n, bj + kBlock); ++j)
+                    m.mtx(i, j) = m.mtx(j, i);
+          }
+          ewt = header.ewt;
+          return true;
+        }
+
+        /** @brief writes the cache to a temporary file renamed on success,
+         * so that concurrent loads never see a partial cache */
+        void save_cache(const TSPLIB_Matrix &m, const std::string &ewt,
+            const struct stat &source) const
+        {
+          CacheHeader header;
+          memset(&header, 0, sizeof(header));
+          memcpy(header.magic, cache_magic(), sizeof(header.magic));
+          header.size = m.size1();
+          header.metric = metric_id(m.dist_);
+          set_source(header, source);
+          size_t n = m.size1();
+          // e.g. asymmetric FULL_MATRIX instances
+          for (size_t i = 0; i < n && !header.metric && !header.full; ++i)
+            for (size_t j = 0; j < i; ++j)
+              if (m.mtx(i, j) != m.mtx(j, i))
+              {
+                header.full = 1;
+                break;
+              }
+          if (ewt.size() >= sizeof(header.ewt)) return;
+          memcpy(header.ewt, ewt.data(), ewt.size());
+          std::string tmp = format("%.%", cache_filename(), getpid());
+          {
+            std::ofstream os(tmp.c_str(), std::ios::binary);
+            os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            if (header.metric)
+              for (const Point & p : m.pos)
+              {
+                os.write(reinterpret_cast<const char *>(&p.x), sizeof(double));
+                os.write(reinterpret_cast<const char *>(&p.y), sizeof(double));
+              }
+            else
+              for (size_t i = 0; i < n; ++i)
+                for (size_t j = 0; j < (header.full ? n : i + 1); ++j)
+                {
+                  int32_t d = m.mtx(i, j);
+                  os.write(reinterpret_cast<const char *>(&d), 4);
+                }
+            if (!os) return (void)remove(tmp.c_str());
+          }
+          if (rename(tmp.c_str(), cache_filename().c_str()))
+            remove(tmp.c_str());
+        }
     };
 
     /**
@@ -0,0 +1,59 @@
+#ifndef TSP_TOUR_H_
+#define TSP_TOUR_H_
+
+#include <cstddef>
+
+#include "rsarray/RSArray.h"
+#include "splay/SplayTree.h"
+#include "tsp/util.h"
+
+namespace tsp
+{
+  /*
+  concept Tour : Cycle
+  {
+    Tour(const Cycle &cycle);
+    friend size_t tour_at(Tour &tour, size_t i);
+    friend void tour_reverse(Tour &tour, size_t begin, size_t end);
+  };
+
+  Models of Tour, with costs of a reversal and of an access:
+    std::vector<size_t>             O(n)        O(1)
+    rsarray::RSArray<size_t>        O(sqrt n)   O(sqrt n)
+    splay::SplayTree<size_t>        O(log n)    O(log n)  (amortized)
+  */
+
+  /** @returns i-th vertex of the tour */
+  template<typename Tour> size_t tour_at(Tour &tour, size_t i)
+  {
+    return tour[i];
+  }
+
+  /** @brief lookups are splayed, so they are amortized O(log n) as well */
+  template<typename T, splay::SplayImplEnum S>
+  size_t tour_at(splay::SplayTree<T, S> &tour, size_t i)
+  {
+    return tour.splay(i)->val_;
+  }
+
+  /** @brief reverses [begin,end) segment of the tour */
+  template<typename Tour>
+  void tour_reverse(Tour &tour, size_t begin, size_t end)
+  {
+    cycle_reverse(tour, begin, end);
+  }
+
+  template<typename T>
+  void tour_reverse(rsarray::RSArray<T> &tour, size_t begin, size_t end)
+  {
+    tour.reverse(begin, end);
+  }
+
+  template<typename T, splay::SplayImplEnum S>
+  void tour_reverse(splay::SplayTree<T, S> &tour, size_t begin, size_t end)
+  {
+    if (begin < end) tour.reverse(begin, end - 1);
+  }
+}  // namespace tsp
+
+#endif  // TSP_TOUR_H_
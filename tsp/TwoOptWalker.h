@@ -6,6 +6,7 @@
 #include <cassert>
 #include <vector>
 
+#include "tsp/Tour.h"
 #include "tsp/util.h"
 
 namespace tsp
@@ -15,8 +16,11 @@ namespace tsp
    *
    * see: http://en.wikipedia.org/wiki/2-opt
    * @param Matrix [implements Matrix]
+   * @param Tour [implements Tour] representation of the cycle; for
+   * rsarray::RSArray and splay::SplayTree the walker is not copyable
    */
-  template<typename Matrix> struct TwoOptWalker
+  template<typename Matrix, typename Tour = std::vector<size_t> >
+  struct TwoOptWalker
   {
       /**
        * @param _matrix [implements Matrix] problem definition (distance matrix)
@@ -37,7 +41,7 @@ namespace tsp
       Split split;
 
     public:
-      std::vector<size_t> cycle;
+      Tour cycle;
 
       double current_fitness()
       {
@@ -58,16 +62,15 @@ namespace tsp
         split.generate(n, random);
         size_t lp = split.begin ? split.begin - 1 : n - 1;
         size_t rn = split.end < n ? split.end : 0;
+        size_t a = tour_at(cycle, lp), b = tour_at(cycle, split.begin);
+        size_t c = tour_at(cycle, split.end - 1), d = tour_at(cycle, rn);
         next_fitness_ = current_fitness_
-            - matrix(cycle[lp], cycle[split.begin])
-            - matrix(cycle[split.end - 1], cycle[rn])
-            + matrix(cycle[lp], cycle[split.end - 1])
-            + matrix(cycle[split.begin], cycle[rn]);
+            - matrix(a, b) - matrix(c, d) + matrix(a, c) + matrix(b, d);
       }
 
       void make_step()
       {
-        cycle_reverse(cycle, split.begin, split.end);
+        tour_reverse(cycle, split.begin, split.end);
         current_fitness_ = next_fitness_;
       }
   };
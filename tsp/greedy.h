@@ -1,20 +1,32 @@
 #ifndef TSP_GREEDY_H_
 #define TSP_GREEDY_H_
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <vector>
 
+#include <boost/pending/disjoint_sets.hpp>
+
+#include "spatial/KDTree.h"
+#include "tsp/EuclidMatrix.h"
+#include "tsp/NeighborLists.h"
+#include "tsp/Points.h"
+#include "tsp/SpaceFillingCurve.h"
 #include "tsp/util.h"
 
 namespace tsp
 {
-  /** @brief greedy O(log n) apx
+  /** @brief greedy O(log n) apx; O(n^2) scan of the matrix
    * see: http://link.springer.com/chapter/10.1007%2F978-1-4020-9688-4_3
    */
   template<typename Matrix, typename Cycle>
-  void greedy(const Matrix &matrix, Cycle &cycle)
+  void greedy_scan(const Matrix &matrix, Cycle &cycle)
   {
     size_t n = matrix.size1();
     cycle.resize(n);
+    if (!n) return;
     std::vector<bool> V(n, 0);
     cycle[0] = 0;
     V[0] = 1;
@@ -29,6 +41,257 @@ namespace tsp
       V[bi] = 1;
     }
   }
+
+  /** @brief greedy_points scans all unvisited points up to this size */
+  static const size_t kGreedyScanLimit = 1000;
+
+  /** @brief greedy for points on the euclidean plane
+   * Up to kGreedyScanLimit points, unvisited points are kept in a compact
+   * structure of arrays, so every step is a single vectorized scan, see:
+   * argmin_sqr_distance. Larger instances query a spatial::KDTree, removing
+   * visited points; O(n log n) expected.
+   * @param pos points
+   * @param cycle [implements Cycle]
+   */
+  template<typename Cycle>
+  void greedy_points(const std::vector<Point> &pos, Cycle &cycle)
+  {
+    size_t n = pos.size();
+    cycle.resize(n);
+    if (!n) return;
+    cycle[0] = 0;
+    if (n > kGreedyScanLimit)
+    {
+      spatial::KDTree tree(pos);
+      tree.remove(0);
+      for (size_t i = 1; i < n; ++i)
+      {
+        uint32_t j = tree.nearest(pos[cycle[i - 1]]);
+        cycle[i] = j;
+        tree.remove(j);
+      }
+      return;
+    }
+    Points left(pos);
+    left.swap_remove(0);
+    for (size_t i = 1; i < n; ++i)
+    {
+      size_t j = argmin_sqr_distance(&left.x[0], &left.y[0], left.size(),
+          pos[cycle[i - 1]]);
+      cycle[i] = left.id[j];
+      left.swap_remove(j);
+    }
+  }
+
+  /**
+   * @brief greedy O(log n) apx, using greedy_points for matrices backed by
+   * points (see: matrix_points) and greedy_scan otherwise
+   *
+   * The distances of all such matrices (EuclidMatrix, and the EUC_2D,
+   * CEIL_2D and ATT metrics of TSPLIB_Matrix) do not decrease with the
+   * euclidean distance, so both pick a nearest vertex, up to ties.
+   * @param matrix [implements Matrix]
+   * @param cycle [implements Cycle]
+   */
+  template<typename Matrix, typename Cycle>
+  void greedy(const Matrix &matrix, Cycle &cycle)
+  {
+    const std::vector<Point> *pos = matrix_points(matrix);
+    if (pos) greedy_points(*pos, cycle);
+    else greedy_scan(matrix, cycle);
+  }
+
+  /** @brief points in the order of the Hilbert curve; O(n log n)
+   * about 25% longer than the optimum for uniformly spread points,
+   * see: hilbert_sort
+   * @param pos points
+   * @param cycle [implements Cycle]
+   */
+  template<typename Cycle>
+  void space_filling_curve(const std::vector<Point> &pos, Cycle &cycle)
+  {
+    std::vector<uint32_t> order;
+    hilbert_sort(pos, order);
+    cycle.resize(order.size());
+    for (size_t i = 0; i < order.size(); ++i) cycle[i] = order[i];
+  }
+
+  /**
+   * @brief sorts keys by their high 32 bits, keeping the order of keys with
+   * equal high bits; LSD radix sort in two passes of 16 bits, std::sort
+   * below 2^16 keys
+   */
+  inline void sort_by_high_bits(std::vector<uint64_t> &keys)
+  {
+    if (keys.size() < (1u << 16))
+    {
+      std::stable_sort(keys.begin(), keys.end(),
+          [](uint64_t a, uint64_t b) { return a >> 32 < b >> 32; });
+      return;
+    }
+    std::vector<uint64_t> sorted(keys.size());
+    std::vector<size_t> start(1 << 16);
+    for (unsigned shift = 32; shift < 64; shift += 16)
+    {
+      std::fill(start.begin(), start.end(), 0);
+      for (uint64_t key : keys) start[key >> shift & 0xffff]++;
+      size_t sum = 0;
+      for (size_t &s : start)
+      {
+        size_t count = s;
+        s = sum;
+        sum += count;
+      }
+      for (uint64_t key : keys) sorted[start[key >> shift & 0xffff]++] = key;
+      keys.swap(sorted);
+    }
+  }
+
+  /**
+   * @brief adds edges between the k nearest neighbours among points ids
+   * by increasing length, as long as no point gets degree 3 and no cycle is
+   * closed, see: greedy_edge
+   * @param adj two neighbours of every point along the paths built so far,
+   *        pos.size() for none
+   * @param dsu [boost::disjoint_sets] vertex sets of the paths
+   * @return number of edges added
+   */
+  template<typename DisjointSets>
+  size_t greedy_edge_round(const std::vector<Point> &pos,
+      const std::vector<uint32_t> &ids, size_t k,
+      std::vector<uint32_t> &adj, DisjointSets &dsu)
+  {
+    size_t m = ids.size();
+    std::vector<Point> subset(m);
+    for (size_t i = 0; i < m; ++i) subset[i] = pos[ids[i]];
+    NeighborLists neighbors;
+    neighbor_lists_grid(subset, k, neighbors);
+    assert(m * neighbors.k <= 0xffffffffu);
+    // squared length in the high bits (the order of non negative floats
+    // is the order of their bits), the index in neighbors.ids in the low;
+    // every edge once: from the lower end, or from the higher one if the
+    // lower end does not list it
+    std::vector<uint64_t> keys;
+    keys.reserve(m * neighbors.k);
+    for (size_t i = 0; i < m; ++i)
+      for (size_t j = 0; j < neighbors.k; ++j)
+      {
+        uint32_t b = neighbors[i][j];
+        if (b < i && std::count(neighbors[b], neighbors[b] + neighbors.k, i))
+          continue;
+        float d = (subset[i] - subset[b]).sqr();
+        uint32_t bits;
+        memcpy(&bits, &d, sizeof(bits));
+        keys.push_back(uint64_t(bits) << 32 | (i * neighbors.k + j));
+      }
+    // keys are pushed by increasing low bits
+    sort_by_high_bits(keys);
+
+    const uint32_t none = pos.size();
+    size_t added = 0;
+    for (uint64_t key : keys)
+    {
+      size_t e = key & 0xffffffffu;
+      uint32_t a = ids[e / neighbors.k], b = ids[neighbors.ids[e]];
+      if (adj[2 * a + 1] != none || adj[2 * b + 1] != none) continue;
+      size_t ra = dsu.find_set(a), rb = dsu.find_set(b);
+      if (ra == rb) continue;
+      dsu.link(ra, rb);
+      adj[2 * a + (adj[2 * a] != none)] = b;
+      adj[2 * b + (adj[2 * b] != none)] = a;
+      ++added;
+    }
+    return added;
+  }
+
+  /** @brief greedy edge heuristic (Bentley) on nearest neighbour graphs
+   *
+   * Paths are built by greedy_edge_round on the k nearest neighbours of all
+   * points, then on the k nearest neighbours among the endpoints of the
+   * paths, and so on; k is doubled whenever no edge gets added, until a
+   * single path is left. Its ends are joined. Paths left by a failed
+   * round (none in exact arithmetic) are concatenated along the Hilbert
+   * curve of their first endpoints, each entered at the nearer endpoint.
+   * About 15-20% longer than the optimum for uniformly spread points;
+   * O(n k log(n k)).
+   * @param pos points
+   * @param cycle [implements Cycle]
+   * @param k candidate neighbours per point
+   */
+  template<typename Cycle>
+  void greedy_edge(const std::vector<Point> &pos, Cycle &cycle, size_t k = 5)
+  {
+    size_t n = pos.size();
+    cycle.resize(n);
+    if (!n) return;
+    const uint32_t none = n;
+    std::vector<uint32_t> adj(2 * n, none);
+    std::vector<size_t> rank(n), parent(n);
+    boost::disjoint_sets<size_t*, size_t*> dsu(&rank[0], &parent[0]);
+    for (size_t v = 0; v < n; ++v) dsu.make_set(v);
+    std::vector<uint32_t> ids(n);
+    for (size_t v = 0; v < n; ++v) ids[v] = v;
+    while (ids.size() > 2)
+    {
+      if (!greedy_edge_round(pos, ids, k, adj, dsu))
+      {
+        // the nearest endpoints lie on the same paths
+        if (k + 1 >= ids.size()) break;
+        k *= 2;
+        continue;
+      }
+      // endpoints of the paths; a single point is a path of its own
+      ids.clear();
+      for (size_t v = 0; v < n; ++v) if (adj[2 * v + 1] == none)
+        ids.push_back(v);
+    }
+
+    // paths, as pairs of endpoints
+    std::vector<uint32_t> first, last;
+    std::vector<bool> seen(n, false);
+    for (size_t v = 0; v < n; ++v)
+    {
+      if (seen[v] || adj[2 * v + 1] != none) continue;
+      uint32_t prev = none, u = v;
+      while (true)
+      {
+        seen[u] = true;
+        uint32_t next = adj[2 * u] != prev ? adj[2 * u] : adj[2 * u + 1];
+        if (next == none) break;
+        prev = u;
+        u = next;
+      }
+      first.push_back(v);
+      last.push_back(u);
+    }
+    std::vector<Point> heads(first.size());
+    for (size_t f = 0; f < first.size(); ++f) heads[f] = pos[first[f]];
+    std::vector<uint32_t> order;
+    hilbert_sort(heads, order);
+
+    size_t i = 0;
+    for (uint32_t f : order)
+    {
+      uint32_t u = first[f];
+      if (i && (pos[cycle[i - 1]] - pos[last[f]]).sqr() <
+          (pos[cycle[i - 1]] - pos[u]).sqr()) u = last[f];
+      for (uint32_t prev = none; u != none;)
+      {
+        cycle[i++] = u;
+        uint32_t next = adj[2 * u] != prev ? adj[2 * u] : adj[2 * u + 1];
+        prev = u;
+        u = next;
+      }
+    }
+    assert(i == n);
+  }
+
+  /** @brief see: greedy_edge */
+  template<typename Cycle>
+  void greedy_edge(const EuclidMatrix &matrix, Cycle &cycle)
+  {
+    greedy_edge(matrix.pos, cycle);
+  }
 }  // namespace tsp
 
 #endif  // TSP_GREEDY_H_
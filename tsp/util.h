@@ -3,7 +3,9 @@
 
 #include <cassert>
 #include <cctype>
+#include <cstdint>
 #include <algorithm>
+#include <vector>
 
 namespace tsp
 {
@@ -50,6 +52,19 @@ namespace tsp
   };
 
 
+  /**
+   * @brief coordinates of the points a matrix is defined on
+   *
+   * Matrices backed by 2D points (see EuclidMatrix, TSPLIB_Matrix) overload
+   * this function, so that geometric algorithms can be used for them.
+   * @return nullptr iff the matrix is not backed by points
+   */
+  template<typename Matrix>
+  const std::vector<Point> * matrix_points(const Matrix &matrix)
+  {
+    return nullptr;
+  }
+
   /**
    * @brief calculates cycle length
    * @tparam Matrix [implements Matrix] square matrix
@@ -96,6 +111,28 @@ namespace tsp
     while (l < r) std::swap(cycle[l++], cycle[--r]);
   }
 
+  /**
+   * @brief reverses cyclic segment of len nodes starting at position l
+   * and keeps the inverse permutation up to date
+   * @param cycle [implements Cycle]
+   * @param pos pos[cycle[i]] == i for all i
+   *
+   * ASSUMPTION: l < cycle.size(), len <= cycle.size()
+   */
+  template<typename Cycle, typename Pos>
+  void cycle_reverse_indexed(Cycle &cycle, Pos &pos, size_t l, size_t len)
+  {
+    size_t n = cycle.size(), r = (l + len + n - 1) % n;
+    for (len /= 2; len--;)
+    {
+      std::swap(cycle[l], cycle[r]);
+      pos[cycle[l]] = l;
+      pos[cycle[r]] = r;
+      l = l + 1 < n ? l + 1 : 0;
+      r = r ? r - 1 : n - 1;
+    }
+  }
+
   /**
    * rotates cycle so that the first element is 0 and the second is
    * its lower neighbour
@@ -146,6 +183,39 @@ namespace tsp
       if (end > n) std::swap(begin, end -= n);
     }
   };
+
+  /** @brief represents moving a cycle segment to another place in the cycle */
+  struct Insertion
+  {
+    /**
+     * the segment consists of @ref len nodes starting at position
+     * @ref begin (cyclically); it is moved forward past @ref shift nodes
+     * and reversed iff @ref reversed
+     */
+    uint32_t begin, len, shift;
+    bool reversed;
+
+    /**
+     * @brief generates an insertion of a segment of length [1,max_len]
+     * to another edge of cycle [0,n)
+     *
+     * the segment length and the edge are uniformly distributed
+     *
+     * @param n cycle size in nodes
+     * @param max_len maximal segment length
+     * @param random [implements Random]
+     */
+    template<typename Random>
+    void generate(uint32_t n, uint32_t max_len, Random &random)
+    {
+      assert(n > 3);
+      max_len = std::min(max_len, n - 3);
+      begin = random() % n;
+      len = random() % max_len + 1;
+      shift = random() % (n - len - 1) + 1;
+      reversed = random() & 1;
+    }
+  };
 }  // namespace tsp
 
 #endif  // TSP_UTIL_H_